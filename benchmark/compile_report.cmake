@@ -0,0 +1,203 @@
+# Measures the compile-time, peak compiler memory and object size of a generated hierarchy
+# for each of the RTTI modes and for native RTTI using dynamic_cast. Run as a script:
+#
+#   cmake -DCOMPILER=<c++> -DSOURCE_DIR=<repo> -DOUTPUT_DIR=<dir> [-DTYPES=500]
+#         [-DFANOUT=4] [-DBASELINE=<csv>] -P compile_report.cmake
+#
+# Type i derives from type (i - 1) / FANOUT, every fourth type also virtually derives from
+# one of 16 interfaces, and each type is constructed and queried once. The peak memory is
+# measured when GNU time is installed as /usr/bin/time. The results are written to
+# OUTPUT_DIR/rtti-compile-report.csv, passing the file of an earlier run as BASELINE reports
+# the change of each measure relative to it.
+
+if(NOT DEFINED TYPES)
+    set(TYPES 500)
+endif()
+if(NOT DEFINED FANOUT)
+    set(FANOUT 4)
+endif()
+
+set(VARIANTS
+    "native\;-frtti\;-DRTTI_SAMPLE_NATIVE"
+    "rtti\;-fno-rtti"
+    "rtti-descriptor\;-fno-rtti\;-DRTTI_USE_TYPE_DESCRIPTOR"
+    "rtti-raw-names\;-fno-rtti\;-DRTTI_RAW_TYPE_NAMES"
+    "rtti-xxh64\;-fno-rtti\;-DRTTI_USE_XXHASH\;-DRTTI_TYPEID_BITS=64"
+)
+
+find_program(TIME_PROGRAM NAMES time PATHS /usr/bin NO_DEFAULT_PATH)
+find_program(SIZE_PROGRAM NAMES size)
+
+# Writes a hierarchy of the passed number of types to DIR/compile_sample_types.hh
+function(generate_types DIR COUNT)
+    set(CONTENT "RTTI_SAMPLE_ROOT(Root)\n")
+    foreach(I RANGE 15)
+        string(APPEND CONTENT "RTTI_SAMPLE_ROOT(Interface${I})\n")
+    endforeach()
+    set(QUERIES "")
+    if(COUNT GREATER 0)
+        foreach(I RANGE 1 ${COUNT})
+            math(EXPR PARENT "(${I} - 1) / ${FANOUT}")
+            math(EXPR INTERFACE "${I} % 64 / 4")
+            if(PARENT EQUAL 0)
+                set(PARENT Root)
+            else()
+                set(PARENT Type${PARENT})
+            endif()
+            math(EXPR MIXIN "${I} % 4")
+            if(MIXIN EQUAL 0)
+                string(APPEND CONTENT
+                    "RTTI_SAMPLE_MIXIN(Type${I}, ${PARENT}, Interface${INTERFACE})\n")
+            else()
+                string(APPEND CONTENT "RTTI_SAMPLE_TYPE(Type${I}, ${PARENT})\n")
+            endif()
+            string(APPEND QUERIES "RTTI_SAMPLE_QUERY(Type${I}, ${PARENT})\n")
+        endforeach()
+    endif()
+    file(WRITE ${DIR}/compile_sample_types.hh "${CONTENT}${QUERIES}")
+endfunction()
+
+# Returns the current time in milliseconds, or in whole seconds before CMake 3.23
+function(now_ms OUT)
+    if(CMAKE_VERSION VERSION_LESS 3.23)
+        string(TIMESTAMP SECONDS "%s")
+        math(EXPR MS "${SECONDS} * 1000")
+    else()
+        string(TIMESTAMP MICROSECONDS "%s%f")
+        string(REGEX REPLACE "...$" "" MS ${MICROSECONDS})
+    endif()
+    set(${OUT} ${MS} PARENT_SCOPE)
+endfunction()
+
+# Compiles the sample, setting <PREFIX>_MS, <PREFIX>_KB and the section sizes
+# <PREFIX>_TEXT, <PREFIX>_RODATA, <PREFIX>_DATA and <PREFIX>_BSS of the object
+function(compile_sample PREFIX DIR)
+    set(OBJECT ${DIR}/compile_sample.o)
+    set(COMMAND ${COMPILER} -std=c++17 -O2 ${ARGN} -I${SOURCE_DIR}/include -I${DIR}
+        -c ${SOURCE_DIR}/benchmark/compile_sample.cc -o ${OBJECT})
+    if(TIME_PROGRAM)
+        set(COMMAND ${TIME_PROGRAM} -f "maxrss %M" ${COMMAND})
+    endif()
+
+    now_ms(START)
+    execute_process(COMMAND ${COMMAND} RESULT_VARIABLE RESULT ERROR_VARIABLE ERRORS)
+    now_ms(END)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "Compiling the sample failed:\n${ERRORS}")
+    endif()
+    math(EXPR MS "${END} - ${START}")
+    set(${PREFIX}_MS ${MS} PARENT_SCOPE)
+
+    set(KB "n/a")
+    if(ERRORS MATCHES "maxrss ([0-9]+)")
+        set(KB ${CMAKE_MATCH_1})
+    endif()
+    set(${PREFIX}_KB ${KB} PARENT_SCOPE)
+
+    execute_process(COMMAND ${SIZE_PROGRAM} -A ${OBJECT} OUTPUT_VARIABLE SECTIONS)
+    string(REPLACE "\n" ";" SECTIONS "${SECTIONS}")
+    foreach(KIND TEXT RODATA DATA BSS)
+        set(${KIND} 0)
+    endforeach()
+    foreach(LINE ${SECTIONS})
+        if(LINE MATCHES "^\\.text[^ ]* +([0-9]+)")
+            math(EXPR TEXT "${TEXT} + ${CMAKE_MATCH_1}")
+        elseif(LINE MATCHES "^\\.rodata[^ ]* +([0-9]+)")
+            math(EXPR RODATA "${RODATA} + ${CMAKE_MATCH_1}")
+        elseif(LINE MATCHES "^\\.data[^ ]* +([0-9]+)")
+            math(EXPR DATA "${DATA} + ${CMAKE_MATCH_1}")
+        elseif(LINE MATCHES "^\\.bss[^ ]* +([0-9]+)")
+            math(EXPR BSS "${BSS} + ${CMAKE_MATCH_1}")
+        endif()
+    endforeach()
+    foreach(KIND TEXT RODATA DATA BSS)
+        set(${PREFIX}_${KIND} ${${KIND}} PARENT_SCOPE)
+    endforeach()
+endfunction()
+
+# Formats the change of a measure relative to the baseline in percent
+function(relative OUT VALUE BASE)
+    if(BASE STREQUAL "" OR BASE STREQUAL "n/a" OR VALUE STREQUAL "n/a" OR BASE EQUAL 0)
+        set(${OUT} "" PARENT_SCOPE)
+        return()
+    endif()
+    math(EXPR PERMILLE "(${VALUE} - ${BASE}) * 1000 / ${BASE}")
+    math(EXPR WHOLE "${PERMILLE} / 10")
+    math(EXPR FRACTION "${PERMILLE} % 10")
+    string(REPLACE "-" "" FRACTION ${FRACTION})
+    set(SIGN "+")
+    if(PERMILLE LESS 0)
+        set(SIGN "")
+        if(WHOLE EQUAL 0)
+            set(SIGN "-")
+        endif()
+    endif()
+    set(${OUT} " (${SIGN}${WHOLE}.${FRACTION}%)" PARENT_SCOPE)
+endfunction()
+
+set(MS_COLUMN compile_ms)
+set(KB_COLUMN peak_kb)
+set(TEXT_COLUMN text)
+set(RODATA_COLUMN rodata)
+set(DATA_COLUMN data)
+set(BSS_COLUMN bss)
+
+# Columns of the baseline are looked up by name, such that older reports remain comparable
+set(BASELINE_LINES "")
+set(BASELINE_COLUMNS "")
+if(DEFINED BASELINE AND EXISTS "${BASELINE}")
+    file(STRINGS ${BASELINE} BASELINE_LINES)
+    list(GET BASELINE_LINES 0 HEADER)
+    string(REPLACE "," ";" BASELINE_COLUMNS "${HEADER}")
+endif()
+
+set(EMPTY_DIR ${OUTPUT_DIR}/compile-report/empty)
+set(SAMPLE_DIR ${OUTPUT_DIR}/compile-report/sample)
+file(MAKE_DIRECTORY ${EMPTY_DIR} ${SAMPLE_DIR})
+generate_types(${EMPTY_DIR} 0)
+generate_types(${SAMPLE_DIR} ${TYPES})
+
+set(CSV "variant,types,compile_ms,peak_kb,text,rodata,data,bss,text_per_type,rodata_per_type,data_per_type,bss_per_type\n")
+message("Compile-time and size of ${TYPES} types, fanout ${FANOUT}:")
+foreach(VARIANT ${VARIANTS})
+    list(GET VARIANT 0 NAME)
+    set(FLAGS ${VARIANT})
+    list(REMOVE_AT FLAGS 0)
+
+    compile_sample(EMPTY ${EMPTY_DIR} ${FLAGS})
+    compile_sample(SAMPLE ${SAMPLE_DIR} ${FLAGS})
+    set(ROW "${NAME},${TYPES},${SAMPLE_MS},${SAMPLE_KB},${SAMPLE_TEXT},${SAMPLE_RODATA},${SAMPLE_DATA},${SAMPLE_BSS}")
+    # The cost per type excludes the cost of the header and the roots
+    foreach(KIND TEXT RODATA DATA BSS)
+        math(EXPR PER_TYPE "(${SAMPLE_${KIND}} - ${EMPTY_${KIND}}) / ${TYPES}")
+        set(${KIND}_PER_TYPE ${PER_TYPE})
+        string(APPEND ROW ",${PER_TYPE}")
+    endforeach()
+    string(APPEND CSV "${ROW}\n")
+
+    set(BASE "")
+    foreach(LINE ${BASELINE_LINES})
+        if(LINE MATCHES "^${NAME},")
+            string(REPLACE "," ";" BASE "${LINE}")
+        endif()
+    endforeach()
+    foreach(FIELD MS KB TEXT RODATA DATA BSS)
+        set(${FIELD}_CHANGE "")
+        list(FIND BASELINE_COLUMNS ${${FIELD}_COLUMN} INDEX)
+        if(BASE AND INDEX GREATER -1)
+            list(GET BASE ${INDEX} BASE_FIELD)
+            relative(${FIELD}_CHANGE ${SAMPLE_${FIELD}} ${BASE_FIELD})
+        endif()
+    endforeach()
+
+    message("  ${NAME}:\n"
+        "    compile time   ${SAMPLE_MS} ms${MS_CHANGE}\n"
+        "    peak memory    ${SAMPLE_KB} KB${KB_CHANGE}\n"
+        "    .text          ${SAMPLE_TEXT} bytes${TEXT_CHANGE}, ${TEXT_PER_TYPE} per type\n"
+        "    .rodata        ${SAMPLE_RODATA} bytes${RODATA_CHANGE}, ${RODATA_PER_TYPE} per type\n"
+        "    .data          ${SAMPLE_DATA} bytes${DATA_CHANGE}, ${DATA_PER_TYPE} per type\n"
+        "    .bss           ${SAMPLE_BSS} bytes${BSS_CHANGE}, ${BSS_PER_TYPE} per type")
+endforeach()
+
+file(WRITE ${OUTPUT_DIR}/rtti-compile-report.csv "${CSV}")
+message("Results written to ${OUTPUT_DIR}/rtti-compile-report.csv")
@@ -0,0 +1,62 @@
+/**
+ * Sample translation unit used to measure the compile-time and code size cost of large
+ * hierarchies. The types are generated by the rtti-compile-report target into
+ * compile_sample_types.hh, which declares each type, a factory and a query on it
+ * through the macros below. When RTTI_SAMPLE_NATIVE is defined the same hierarchy is
+ * declared without the library and queried using dynamic_cast.
+ */
+#ifdef RTTI_SAMPLE_NATIVE
+
+#define RTTI_SAMPLE_ROOT(T)     \
+    struct T {                  \
+        virtual ~T() = default; \
+    };
+
+#define RTTI_SAMPLE_TYPE(T, Parent) \
+    struct T : Parent {};
+
+#define RTTI_SAMPLE_MIXIN(T, Parent, Interface) \
+    struct T                                    \
+        : Parent                                \
+        , virtual Interface {};
+
+#define RTTI_SAMPLE_QUERY(T, Parent)                                                  \
+    Root* Create##T() {                                                               \
+        return new T();                                                               \
+    }                                                                                 \
+    bool Query##T(Root* object) {                                                     \
+        return dynamic_cast<T*>(object) != nullptr && dynamic_cast<Parent*>(object); \
+    }
+
+#else
+
+#include <rtti.hh>
+
+#define RTTI_SAMPLE_ROOT(T)           \
+    struct T : virtual RTTI::Enable { \
+        RTTI_DECLARE_TYPEINFO(T);     \
+    };
+
+#define RTTI_SAMPLE_TYPE(T, Parent)        \
+    struct T : Parent {                    \
+        RTTI_DECLARE_TYPEINFO(T, Parent);  \
+    };
+
+#define RTTI_SAMPLE_MIXIN(T, Parent, Interface)       \
+    struct T                                          \
+        : Parent                                      \
+        , virtual Interface {                         \
+        RTTI_DECLARE_TYPEINFO(T, Parent, Interface);  \
+    };
+
+#define RTTI_SAMPLE_QUERY(T, Parent)                                 \
+    Root* Create##T() {                                              \
+        return new T();                                              \
+    }                                                                \
+    bool Query##T(Root* object) {                                    \
+        return object->cast<T>() != nullptr && object->is<Parent>(); \
+    }
+
+#endif
+
+#include "compile_sample_types.hh"
@@ -0,0 +1,32 @@
+/**
+ * Sample translation unit used to compare the compile-time cost of the type identifier
+ * hashes. Computes the identifiers of a family of types with long template names at
+ * compile-time, select the hash using RTTI_TYPEID_BITS and RTTI_USE_XXHASH.
+ */
+#include <rtti.hh>
+
+template <typename T>
+struct Wrap {};
+
+template <std::size_t N, std::size_t Depth>
+struct Nest {
+    using type = Wrap<typename Nest<N, Depth - 1>::type>;
+};
+
+template <std::size_t N>
+struct Nest<N, 0> {
+    using type = std::integral_constant<std::size_t, N>;
+};
+
+template <std::size_t... Ns>
+constexpr RTTI::TypeId
+CombineIds(std::index_sequence<Ns...>) {
+    return (RTTI::TypeInfo<typename Nest<Ns, 24>::type>::Id() ^ ...);
+}
+
+constexpr RTTI::TypeId Combined = CombineIds(std::make_index_sequence<256>{});
+
+RTTI::TypeId
+CombinedTypeIds() {
+    return Combined;
+}
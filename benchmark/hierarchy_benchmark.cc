@@ -0,0 +1,311 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <rtti.hh>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Shape of a generated hierarchy. The leaf type derives from a chain of Depth types,
+ * from Width interfaces and from Diamonds pairs of types sharing a virtual base. The
+ * types of the chain derive from each other virtually in case Virtual is set.
+ */
+template <std::size_t DepthV, std::size_t WidthV, std::size_t DiamondsV, bool VirtualV>
+struct Shape {
+    static_assert(DepthV >= 1, "The chain of a hierarchy holds at least its root.");
+
+    static constexpr std::size_t Depth = DepthV;
+    static constexpr std::size_t Width = WidthV;
+    static constexpr std::size_t Diamonds = DiamondsV;
+    static constexpr bool Virtual = VirtualV;
+};
+
+template <typename Base, bool Virtual>
+struct Inherit : Base {};
+
+template <typename Base>
+struct Inherit<Base, true> : virtual Base {};
+
+/// Chain of types of a hierarchy, Chain<S, 0> being its root.
+template <typename S, std::size_t N>
+struct Chain : Inherit<Chain<S, N - 1>, S::Virtual> {
+    RTTI_DECLARE_TYPEINFO(Chain, Chain<S, N - 1>);
+};
+
+template <typename S>
+struct Chain<S, 0> : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Chain);
+};
+
+template <typename S>
+using Root = Chain<S, 0>;
+
+template <typename S, std::size_t N>
+struct Interface : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Interface);
+};
+
+template <typename S, std::size_t N>
+struct Apex : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Apex);
+};
+
+template <typename S, std::size_t N, std::size_t Side>
+struct Edge : virtual Apex<S, N> {
+    RTTI_DECLARE_TYPEINFO(Edge, Apex<S, N>);
+};
+
+template <typename S, typename Interfaces, typename Diamonds>
+struct LeafOf;
+
+template <typename S, std::size_t... Is, std::size_t... Ds>
+struct LeafOf<S, std::index_sequence<Is...>, std::index_sequence<Ds...>>
+    : Chain<S, S::Depth - 1>
+    , Interface<S, Is>...
+    , Edge<S, Ds, 0>...
+    , Edge<S, Ds, 1>... {
+    RTTI_DECLARE_TYPEINFO(LeafOf, Chain<S, S::Depth - 1>, Interface<S, Is>..., Edge<S, Ds, 0>...,
+                          Edge<S, Ds, 1>...);
+};
+
+/// Most derived type of a hierarchy.
+template <typename S>
+using Leaf =
+    LeafOf<S, std::make_index_sequence<S::Width>, std::make_index_sequence<S::Diamonds>>;
+
+/// Type sharing all ancestors of the chain with the leaf, the target of missing casts.
+template <typename S>
+struct Sibling : Chain<S, S::Depth - 1> {
+    RTTI_DECLARE_TYPEINFO(Sibling, Chain<S, S::Depth - 1>);
+};
+
+struct Rtti {
+    static constexpr char const* Name = "rtti";
+
+    template <typename T, typename U>
+    static T* Cast(U* ptr) noexcept {
+        return RTTI::cast<T>(ptr);
+    }
+
+    template <typename T, typename U>
+    static bool Is(U* ptr) noexcept {
+        return RTTI::is<T>(ptr);
+    }
+};
+
+struct Native {
+    static constexpr char const* Name = "native";
+
+    template <typename T, typename U>
+    static T* Cast(U* ptr) noexcept {
+        return dynamic_cast<T*>(ptr);
+    }
+
+    template <typename T, typename U>
+    static bool Is(U* ptr) noexcept {
+        return dynamic_cast<T*>(ptr) != nullptr;
+    }
+};
+
+/// Records the shape of the hierarchy as counters, such that it is part of the JSON output.
+template <typename S>
+static void
+SetShapeCounters(benchmark::State& state) {
+    state.counters["depth"] = S::Depth;
+    state.counters["width"] = S::Width;
+    state.counters["diamonds"] = S::Diamonds;
+    state.counters["virtual"] = S::Virtual;
+}
+
+template <typename S, typename C>
+static void
+UpCast(benchmark::State& state) {
+    Leaf<S> leaf;
+    Leaf<S>* ptr = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ptr);
+        benchmark::DoNotOptimize(C::template Cast<Root<S>>(ptr));
+    }
+    SetShapeCounters<S>(state);
+}
+
+template <typename S, typename C>
+static void
+DownCast(benchmark::State& state) {
+    Leaf<S> leaf;
+    Root<S>* root = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(C::template Cast<Leaf<S>>(root));
+    }
+    SetShapeCounters<S>(state);
+}
+
+template <typename S, typename C>
+static void
+MissCast(benchmark::State& state) {
+    Leaf<S> leaf;
+    Root<S>* root = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(C::template Cast<Sibling<S>>(root));
+    }
+    SetShapeCounters<S>(state);
+}
+
+template <typename S, typename C>
+static void
+Is(benchmark::State& state) {
+    Leaf<S> leaf;
+    Root<S>* root = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(C::template Is<Leaf<S>>(root));
+    }
+    SetShapeCounters<S>(state);
+}
+
+/// Downcasts a run of leaves and siblings, the argument being the percentage of leaves.
+template <typename S, typename C>
+static void
+HitRatio(benchmark::State& state) {
+    std::vector<std::unique_ptr<Root<S>>> objects(1024);
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        if (i * 100 < objects.size() * static_cast<std::size_t>(state.range(0))) {
+            objects[i] = std::make_unique<Leaf<S>>();
+        } else {
+            objects[i] = std::make_unique<Sibling<S>>();
+        }
+    }
+    std::shuffle(objects.begin(), objects.end(), std::mt19937(42));
+
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& object : objects) {
+            hits += C::template Cast<Leaf<S>>(object.get()) != nullptr;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+    SetShapeCounters<S>(state);
+}
+
+/// Shape of the hierarchy of the cache-cold workload.
+using ColdShape = Shape<16, 8, 0, false>;
+
+/// Types of the cache-cold workload, each with its own depth and interface.
+template <std::size_t N>
+struct Cold
+    : Chain<ColdShape, N % ColdShape::Depth>
+    , Interface<ColdShape, N / ColdShape::Depth % ColdShape::Width> {
+    RTTI_DECLARE_TYPEINFO(Cold, Chain<ColdShape, N % ColdShape::Depth>,
+                          Interface<ColdShape, N / ColdShape::Depth % ColdShape::Width>);
+};
+
+static constexpr std::size_t ColdTypes = 256;
+
+template <std::size_t... Ns>
+static std::vector<Root<ColdShape>* (*)()>
+ColdFactories(std::index_sequence<Ns...>) {
+    return {[]() -> Root<ColdShape>* { return new Cold<Ns>(); }...};
+}
+
+/**
+ * Casts a run of objects of hundreds of types, allocated in random order such that
+ * neither the objects nor their type information stay in the caches. The argument is
+ * the number of objects.
+ */
+template <typename C>
+static void
+ColdCast(benchmark::State& state) {
+    auto const factories = ColdFactories(std::make_index_sequence<ColdTypes>{});
+    std::mt19937 random(42);
+    std::vector<std::unique_ptr<Root<ColdShape>>> objects(static_cast<std::size_t>(state.range(0)));
+    for (auto& object : objects) {
+        object.reset(factories[random() % factories.size()]());
+    }
+    std::shuffle(objects.begin(), objects.end(), random);
+
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& object : objects) {
+            hits += C::template Cast<Chain<ColdShape, 8>>(object.get()) != nullptr;
+            hits += C::template Cast<Interface<ColdShape, 3>>(object.get()) != nullptr;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size() * 2);
+    state.counters["types"] = ColdTypes;
+}
+
+template <typename S, typename C>
+static void
+RegisterShape() {
+    auto const name = std::string("/") + C::Name + "/depth:" + std::to_string(S::Depth) +
+                      "/width:" + std::to_string(S::Width) +
+                      "/diamonds:" + std::to_string(S::Diamonds) +
+                      "/virtual:" + std::to_string(S::Virtual);
+    benchmark::RegisterBenchmark(("UpCast" + name).c_str(), UpCast<S, C>);
+    benchmark::RegisterBenchmark(("DownCast" + name).c_str(), DownCast<S, C>);
+    benchmark::RegisterBenchmark(("MissCast" + name).c_str(), MissCast<S, C>);
+    benchmark::RegisterBenchmark(("Is" + name).c_str(), Is<S, C>);
+}
+
+template <typename... Shapes>
+static void
+RegisterShapes() {
+    (RegisterShape<Shapes, Rtti>(), ...);
+    (RegisterShape<Shapes, Native>(), ...);
+}
+
+template <typename S, typename C>
+static void
+RegisterHitRatio() {
+    benchmark::RegisterBenchmark((std::string("HitRatio/") + C::Name).c_str(), HitRatio<S, C>)
+        ->ArgName("hits")
+        ->Arg(0)
+        ->Arg(50)
+        ->Arg(90)
+        ->Arg(100);
+}
+
+template <typename C>
+static void
+RegisterColdCast() {
+    benchmark::RegisterBenchmark((std::string("ColdCast/") + C::Name).c_str(), ColdCast<C>)
+        ->ArgName("objects")
+        ->Arg(1 << 10)
+        ->Arg(1 << 22);
+}
+
+int
+main(int argc, char** argv) {
+    // Depth of a single chain
+    RegisterShapes<Shape<1, 0, 0, false>, Shape<2, 0, 0, false>, Shape<4, 0, 0, false>,
+                   Shape<8, 0, 0, false>, Shape<16, 0, 0, false>, Shape<32, 0, 0, false>>();
+
+    // Width, diamonds and virtual bases
+    RegisterShapes<Shape<4, 2, 0, false>, Shape<4, 8, 0, false>, Shape<4, 0, 1, false>,
+                   Shape<4, 0, 4, false>, Shape<4, 0, 0, true>, Shape<16, 0, 0, true>,
+                   Shape<8, 4, 2, true>>();
+
+    RegisterHitRatio<Shape<8, 2, 1, false>, Rtti>();
+    RegisterHitRatio<Shape<8, 2, 1, false>, Native>();
+    RegisterColdCast<Rtti>();
+    RegisterColdCast<Native>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Dumps the hierarchy of all registered types annotated with the cost of casting, as DOT
+ * or JSON depending on the first argument. Linking the translation units registering the
+ * types of a project against this file dumps the hierarchy of the project, the sample
+ * types below are registered only when RTTI_DUMP_SAMPLE is defined.
+ */
+#include <analysis.hh>
+#include <cstdio>
+#include <string_view>
+
+#ifdef RTTI_DUMP_SAMPLE
+namespace Sample {
+    struct Shape : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Shape);
+    };
+
+    struct Drawable : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Drawable);
+    };
+
+    struct Polygon
+        : Shape
+        , Drawable {
+        RTTI_DECLARE_TYPEINFO(Polygon, Shape, Drawable);
+    };
+
+    struct Rectangle : virtual Polygon {
+        RTTI_DECLARE_TYPEINFO(Rectangle, Polygon);
+    };
+
+    struct Rhombus : virtual Polygon {
+        RTTI_DECLARE_TYPEINFO(Rhombus, Polygon);
+    };
+
+    struct Square
+        : Rectangle
+        , Rhombus {
+        RTTI_DECLARE_TYPEINFO(Square, Rectangle, Rhombus);
+    };
+
+    struct Circle : Shape {
+        RTTI_DECLARE_TYPEINFO(Circle, Shape);
+    };
+
+    RTTI_REGISTER(Square);
+    RTTI_REGISTER(Circle);
+
+    RTTI_MAX_CAST_COST(Square, 1);
+}  // namespace Sample
+#endif
+
+int
+main(int argc, char** argv) {
+    auto const format = std::string_view(argc > 1 ? argv[1] : "dot");
+    if (format != "dot" && format != "json") {
+        std::fprintf(stderr, "Usage: %s [dot|json]\n", argv[0]);
+        return 1;
+    }
+
+    auto const hierarchy = RTTI::Analysis::Hierarchy::Registered();
+    auto const output = format == "dot" ? hierarchy.toDot() : hierarchy.toJson() + "\n";
+    std::fputs(output.c_str(), stdout);
+    return 0;
+}
@@ -1,6 +1,24 @@
 #include <benchmark/benchmark.h>
 
+#include <any.hh>
+#include <batch.hh>
+#include <algorithm>
+#include <any>
+#include <cached_cast.hh>
+#include <dispatch.hh>
+#include <event_bus.hh>
+#include <functional>
 #include <rtti.hh>
+#include <memory>
+#include <pointer_cast.hh>
+#include <poly_vector.hh>
+#include <registry.hh>
+#include <shared_mutex>
+#include <string>
+#include <type_map.hh>
+#include <unordered_map>
+#include <vector>
+#include <visit.hh>
 
 struct GrandParent : virtual RTTI::Enable {
     RTTI_DECLARE_TYPEINFO(GrandParent);
@@ -22,6 +40,38 @@ struct Child
 
 struct InvalidCast {};
 
+/// Single-root hierarchy without the virtual RTTI::Enable base.
+struct RootNode : RTTI::EnableRoot<RootNode> {
+    RTTI_DECLARE_TYPEINFO(RootNode);
+};
+
+struct BranchNode : RootNode {
+    RTTI_DECLARE_TYPEINFO(BranchNode, RootNode);
+};
+
+struct LeafNode : BranchNode {
+    RTTI_DECLARE_TYPEINFO(LeafNode, BranchNode);
+};
+
+/// Interface mixed in at every level of the Level<N> hierarchy.
+template <std::size_t N>
+struct Interface : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Interface<N>);
+};
+
+/// Hierarchy of depth N where each level also implements an interface.
+template <std::size_t N>
+struct Level
+    : Level<N - 1>
+    , Interface<N> {
+    RTTI_DECLARE_TYPEINFO(Level<N>, Level<N - 1>, Interface<N>);
+};
+
+template <>
+struct Level<0> : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Level<0>);
+};
+
 static void
 NativeDynamicCast(benchmark::State& state) {
     for (auto _ : state) {
@@ -76,4 +126,826 @@ RttiDynamicCast(benchmark::State& state) {
 }
 BENCHMARK(RttiDynamicCast);
 
+/// Message hierarchies used to compare cast chains with visit, one of them sealed.
+struct OpenTag {};
+struct SealedTag {};
+
+template <typename Tag>
+struct MessageBase : RTTI::EnableRoot<MessageBase<Tag>> {
+    RTTI_DECLARE_TYPEINFO(MessageBase<Tag>);
+};
+
+template <typename Tag, int N>
+struct Message : MessageBase<Tag> {
+    RTTI_DECLARE_TYPEINFO(Message, MessageBase<Tag>);
+};
+
+using SealedBase = MessageBase<SealedTag>;
+using Sealed0 = Message<SealedTag, 0>;
+using Sealed1 = Message<SealedTag, 1>;
+using Sealed2 = Message<SealedTag, 2>;
+using Sealed3 = Message<SealedTag, 3>;
+using Sealed4 = Message<SealedTag, 4>;
+using Sealed5 = Message<SealedTag, 5>;
+using Sealed6 = Message<SealedTag, 6>;
+using Sealed7 = Message<SealedTag, 7>;
+RTTI_DECLARE_SEALED(SealedBase, Sealed0, Sealed1, Sealed2, Sealed3, Sealed4, Sealed5, Sealed6,
+                    Sealed7);
+
+static void
+RttiRootDownCast(benchmark::State& state) {
+    LeafNode leaf;
+    RootNode* root = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(root->cast<LeafNode>());
+        benchmark::DoNotOptimize(root->cast<BranchNode>());
+        benchmark::DoNotOptimize(root->cast<InvalidCast>());
+    }
+}
+BENCHMARK(RttiRootDownCast);
+
+static void
+RttiStaticUpCast(benchmark::State& state) {
+    Level<7> leaf;
+    Level<7>* ptr = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ptr);
+        benchmark::DoNotOptimize(ptr->cast<Level<0>>());
+        benchmark::DoNotOptimize(ptr->cast<Interface<3>>());
+        benchmark::DoNotOptimize(ptr->is<Level<5>>());
+    }
+}
+BENCHMARK(RttiStaticUpCast);
+
+template <std::size_t N>
+static void
+NativeDynamicCastDepth(benchmark::State& state) {
+    Level<N> leaf;
+    Level<0>* root = &leaf;
+    Interface<1>* interface = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(interface);
+        benchmark::DoNotOptimize(dynamic_cast<Level<N>*>(root));
+        benchmark::DoNotOptimize(dynamic_cast<Level<0>*>(interface));
+        benchmark::DoNotOptimize(dynamic_cast<Level<N + 1>*>(root));
+    }
+}
+BENCHMARK_TEMPLATE(NativeDynamicCastDepth, 1);
+BENCHMARK_TEMPLATE(NativeDynamicCastDepth, 3);
+BENCHMARK_TEMPLATE(NativeDynamicCastDepth, 5);
+BENCHMARK_TEMPLATE(NativeDynamicCastDepth, 7);
+
+template <std::size_t N>
+static void
+RttiDynamicCastDepth(benchmark::State& state) {
+    Level<N> leaf;
+    Level<0>* root = &leaf;
+    Interface<1>* interface = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root);
+        benchmark::DoNotOptimize(interface);
+        benchmark::DoNotOptimize(root->cast<Level<N>>());
+        benchmark::DoNotOptimize(interface->cast<Level<0>>());
+        benchmark::DoNotOptimize(root->cast<Level<N + 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(RttiDynamicCastDepth, 1);
+BENCHMARK_TEMPLATE(RttiDynamicCastDepth, 3);
+BENCHMARK_TEMPLATE(RttiDynamicCastDepth, 5);
+BENCHMARK_TEMPLATE(RttiDynamicCastDepth, 7);
+
+template <std::size_t N>
+static void
+RttiIsDepth(benchmark::State& state) {
+    Level<N> leaf;
+    Interface<1>* interface = &leaf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(interface);
+        benchmark::DoNotOptimize(interface->is<Level<0>>());
+        benchmark::DoNotOptimize(interface->is<Level<N>>());
+        benchmark::DoNotOptimize(interface->is<Level<N + 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(RttiIsDepth, 1);
+BENCHMARK_TEMPLATE(RttiIsDepth, 3);
+BENCHMARK_TEMPLATE(RttiIsDepth, 5);
+BENCHMARK_TEMPLATE(RttiIsDepth, 7);
+
+/// Objects of state.range(0) distinct dynamic types, cycled through in order.
+static std::vector<std::unique_ptr<Level<0>>>
+MakeMixedObjects(std::size_t types) {
+    std::vector<std::unique_ptr<Level<0>>> objects;
+    for (std::size_t i = 0; i < 64; ++i) {
+        switch (i % types) {
+            case 0: objects.emplace_back(std::make_unique<Level<1>>()); break;
+            case 1: objects.emplace_back(std::make_unique<Level<2>>()); break;
+            case 2: objects.emplace_back(std::make_unique<Level<3>>()); break;
+            case 3: objects.emplace_back(std::make_unique<Level<4>>()); break;
+            case 4: objects.emplace_back(std::make_unique<Level<5>>()); break;
+            case 5: objects.emplace_back(std::make_unique<Level<6>>()); break;
+            case 6: objects.emplace_back(std::make_unique<Level<7>>()); break;
+            default: objects.emplace_back(std::make_unique<Level<8>>()); break;
+        }
+    }
+    return objects;
+}
+
+static void
+RttiCast(benchmark::State& state) {
+    auto const objects = MakeMixedObjects(state.range(0));
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            benchmark::DoNotOptimize(object->cast<Interface<1>>());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(RttiCast)->Arg(1)->Arg(2)->Arg(8);
+
+static void
+RttiCastCached(benchmark::State& state) {
+    auto const objects = MakeMixedObjects(state.range(0));
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            benchmark::DoNotOptimize(RTTI_CAST_CACHED(Interface<1>, object.get()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(RttiCastCached)->Arg(1)->Arg(2)->Arg(8);
+
+template <typename Tag>
+static std::vector<std::unique_ptr<MessageBase<Tag>>>
+MakeMessages() {
+    std::vector<std::unique_ptr<MessageBase<Tag>>> messages;
+    for (int i = 0; i < 8; ++i) {
+        messages.emplace_back(std::make_unique<Message<Tag, 0>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 1>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 2>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 3>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 4>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 5>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 6>>());
+        messages.emplace_back(std::make_unique<Message<Tag, 7>>());
+    }
+    return messages;
+}
+
+static void
+RttiCastChain(benchmark::State& state) {
+    auto const messages = MakeMessages<OpenTag>();
+
+    for (auto _ : state) {
+        for (auto const& message : messages) {
+            int result = -1;
+            if (message->template cast<Message<OpenTag, 0>>()) {
+                result = 0;
+            } else if (message->template cast<Message<OpenTag, 1>>()) {
+                result = 1;
+            } else if (message->template cast<Message<OpenTag, 2>>()) {
+                result = 2;
+            } else if (message->template cast<Message<OpenTag, 3>>()) {
+                result = 3;
+            } else if (message->template cast<Message<OpenTag, 4>>()) {
+                result = 4;
+            } else if (message->template cast<Message<OpenTag, 5>>()) {
+                result = 5;
+            } else if (message->template cast<Message<OpenTag, 6>>()) {
+                result = 6;
+            } else if (message->template cast<Message<OpenTag, 7>>()) {
+                result = 7;
+            }
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(RttiCastChain);
+
+template <typename Tag>
+static void
+RttiVisit(benchmark::State& state) {
+    auto const messages = MakeMessages<Tag>();
+
+    for (auto _ : state) {
+        for (auto const& message : messages) {
+            benchmark::DoNotOptimize(RTTI::visit(
+                *message, [](Message<Tag, 0>&) { return 0; }, [](Message<Tag, 1>&) { return 1; },
+                [](Message<Tag, 2>&) { return 2; }, [](Message<Tag, 3>&) { return 3; },
+                [](Message<Tag, 4>&) { return 4; }, [](Message<Tag, 5>&) { return 5; },
+                [](Message<Tag, 6>&) { return 6; }, [](Message<Tag, 7>&) { return 7; }));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK_TEMPLATE(RttiVisit, OpenTag);
+BENCHMARK_TEMPLATE(RttiVisit, SealedTag);
+
+static void
+RttiCastLadder2(benchmark::State& state) {
+    auto const messages = MakeMessages<OpenTag>();
+    using M0 = Message<OpenTag, 0>;
+    using M1 = Message<OpenTag, 1>;
+    using M2 = Message<OpenTag, 2>;
+    using M3 = Message<OpenTag, 3>;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i + 1 < messages.size(); ++i) {
+            auto* a = messages[i].get();
+            auto* b = messages[i + 1].get();
+            int result = -1;
+            if (a->template cast<M0>()) {
+                if (b->template cast<M0>()) {
+                    result = 0;
+                } else if (b->template cast<M1>()) {
+                    result = 1;
+                }
+            } else if (a->template cast<M1>()) {
+                if (b->template cast<M2>()) {
+                    result = 2;
+                } else if (b->template cast<M3>()) {
+                    result = 3;
+                }
+            } else if (a->template cast<M2>()) {
+                if (b->template cast<M3>()) {
+                    result = 4;
+                }
+            }
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (messages.size() - 1));
+}
+BENCHMARK(RttiCastLadder2);
+
+static void
+RttiDispatch2(benchmark::State& state) {
+    auto const messages = MakeMessages<OpenTag>();
+    using M0 = Message<OpenTag, 0>;
+    using M1 = Message<OpenTag, 1>;
+    using M2 = Message<OpenTag, 2>;
+    using M3 = Message<OpenTag, 3>;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i + 1 < messages.size(); ++i) {
+            benchmark::DoNotOptimize(RTTI::dispatch2(
+                *messages[i], *messages[i + 1], [](M0&, M0&) { return 0; },
+                [](M0&, M1&) { return 1; }, [](M1&, M2&) { return 2; },
+                [](M1&, M3&) { return 3; }, [](M2&, M3&) { return 4; }));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (messages.size() - 1));
+}
+BENCHMARK(RttiDispatch2);
+
+/// Objects of mixed dynamic types and a large array of pointers referencing them.
+struct BatchObjects {
+    std::vector<std::unique_ptr<Level<0>>> pool;
+    std::vector<Level<0>*> pointers;
+};
+
+static BatchObjects
+MakeBatchObjects(std::size_t count) {
+    BatchObjects objects;
+    auto const poolSize = std::min<std::size_t>(count, 1 << 20);
+    for (std::size_t i = 0; i < poolSize; ++i) {
+        switch (i % 8) {
+            case 0: objects.pool.emplace_back(std::make_unique<Level<1>>()); break;
+            case 1: objects.pool.emplace_back(std::make_unique<Level<2>>()); break;
+            case 2: objects.pool.emplace_back(std::make_unique<Level<3>>()); break;
+            case 3: objects.pool.emplace_back(std::make_unique<Level<4>>()); break;
+            case 4: objects.pool.emplace_back(std::make_unique<Level<5>>()); break;
+            case 5: objects.pool.emplace_back(std::make_unique<Level<6>>()); break;
+            case 6: objects.pool.emplace_back(std::make_unique<Level<7>>()); break;
+            default: objects.pool.emplace_back(std::make_unique<Level<8>>()); break;
+        }
+    }
+    objects.pointers.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        objects.pointers[i] = objects.pool[(i * 2654435761u) % poolSize].get();
+    }
+    return objects;
+}
+
+static void
+RttiIsLoop(benchmark::State& state) {
+    auto const objects = MakeBatchObjects(state.range(0));
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (auto const* object : objects.pointers) {
+            count += object->is<Interface<3>>() ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RttiIsLoop)->Arg(1000)->Arg(1000000)->Arg(100000000);
+
+static void
+RttiBatchCountIs(benchmark::State& state) {
+    auto const objects = MakeBatchObjects(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(RTTI::count_is<Interface<3>>(objects.pointers));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RttiBatchCountIs)->Arg(1000)->Arg(1000000)->Arg(100000000);
+
+static void
+RttiPartitionLoop(benchmark::State& state) {
+    auto objects = MakeBatchObjects(state.range(0));
+    std::vector<Level<0>*> partitioned(objects.pointers.size());
+
+    for (auto _ : state) {
+        std::size_t first = 0;
+        std::size_t last = partitioned.size();
+        for (auto* object : objects.pointers) {
+            if (object->is<Interface<3>>()) {
+                partitioned[first++] = object;
+            } else {
+                partitioned[--last] = object;
+            }
+        }
+        benchmark::DoNotOptimize(partitioned.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RttiPartitionLoop)->Arg(1000)->Arg(1000000)->Arg(100000000);
+
+static void
+RttiBatchPartitionByType(benchmark::State& state) {
+    auto objects = MakeBatchObjects(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(RTTI::partition_by_type<Interface<3>>(objects.pointers));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RttiBatchPartitionByType)->Arg(1000)->Arg(1000000)->Arg(100000000);
+
+template <typename Container>
+static void
+AddMixedObjects(Container& container, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (i % 8) {
+            case 0: container.template emplace<Level<1>>(); break;
+            case 1: container.template emplace<Level<2>>(); break;
+            case 2: container.template emplace<Level<3>>(); break;
+            case 3: container.template emplace<Level<4>>(); break;
+            case 4: container.template emplace<Level<5>>(); break;
+            case 5: container.template emplace<Level<6>>(); break;
+            case 6: container.template emplace<Level<7>>(); break;
+            default: container.template emplace<Level<8>>(); break;
+        }
+    }
+}
+
+/// Vector of individually allocated objects with the interface of a PolyVector.
+struct UniquePtrVector {
+    template <typename T>
+    void emplace() {
+        objects.emplace_back(std::make_unique<T>());
+    }
+
+    std::vector<std::unique_ptr<Level<0>>> objects;
+};
+
+static void
+UniquePtrVectorCastLoop(benchmark::State& state) {
+    UniquePtrVector objects;
+    AddMixedObjects(objects, state.range(0));
+
+    for (auto _ : state) {
+        for (auto const& object : objects.objects) {
+            if (auto* const level = object->cast<Level<3>>()) {
+                benchmark::DoNotOptimize(level);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(UniquePtrVectorCastLoop)->Arg(1000)->Arg(1000000);
+
+static void
+PolyVectorForEach(benchmark::State& state) {
+    RTTI::PolyVector<Level<0>> objects;
+    AddMixedObjects(objects, state.range(0));
+
+    for (auto _ : state) {
+        objects.for_each<Level<3>>([](Level<3>& level) { benchmark::DoNotOptimize(&level); });
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PolyVectorForEach)->Arg(1000)->Arg(1000000);
+
+RTTI_REGISTER(Level<4>);
+
+static void
+UniquePtrCreate(benchmark::State& state) {
+    std::vector<std::unique_ptr<Level<0>>> objects(64);
+
+    for (auto _ : state) {
+        for (auto& object : objects) {
+            object = std::make_unique<Level<4>>();
+        }
+        for (auto& object : objects) {
+            object.reset();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(UniquePtrCreate);
+
+static void
+RttiRegistryCreate(benchmark::State& state) {
+    std::vector<RTTI::Pooled<Level<0>>> objects(64);
+    auto const typeId = RTTI::TypeInfo<Level<4>>::Id();
+
+    for (auto _ : state) {
+        for (auto& object : objects) {
+            object = RTTI::create<Level<0>>(typeId);
+        }
+        for (auto& object : objects) {
+            object.reset();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(RttiRegistryCreate);
+
+/// Number of subscribers, each subscribed to one of the interfaces of the Level<N> hierarchy.
+static constexpr std::size_t EventSubscribers = 64;
+
+template <std::size_t... Ns>
+static void
+SubscribeInterfaces(RTTI::EventBus& bus, std::index_sequence<Ns...>) {
+    for (std::size_t i = 0; i < EventSubscribers / sizeof...(Ns); ++i) {
+        (bus.subscribe<Interface<Ns + 1>>(
+             [](Interface<Ns + 1>& event) { benchmark::DoNotOptimize(&event); }),
+         ...);
+    }
+}
+
+/// Publisher looping over all subscribers, guarded against concurrent subscriptions.
+struct NaiveEventBus {
+    struct Subscriber {
+        void* (*cast)(RTTI::Enable* event);
+        std::function<void(void*)> handler;
+    };
+
+    template <std::size_t... Ns>
+    explicit NaiveEventBus(std::index_sequence<Ns...>) {
+        for (std::size_t i = 0; i < EventSubscribers / sizeof...(Ns); ++i) {
+            (subscribers.push_back(Subscriber{
+                 [](RTTI::Enable* event) -> void* { return RTTI::cast<Interface<Ns + 1>>(event); },
+                 [](void* event) { benchmark::DoNotOptimize(event); }}),
+             ...);
+        }
+    }
+
+    std::size_t publish(RTTI::Enable& event) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        std::size_t count = 0;
+        for (auto const& subscriber : subscribers) {
+            if (auto* target = subscriber.cast(&event)) {
+                subscriber.handler(target);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::vector<Subscriber> subscribers;
+    std::shared_mutex mutex;
+};
+
+static void
+NaivePublish(benchmark::State& state) {
+    static NaiveEventBus bus(std::make_index_sequence<8>{});
+    Level<4> level4;
+    Level<7> level7;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.publish(level4));
+        benchmark::DoNotOptimize(bus.publish(level7));
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(NaivePublish)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+RttiEventBusPublish(benchmark::State& state) {
+    static RTTI::EventBus bus;
+    if (state.thread_index() == 0 && bus.size() == 0) {
+        SubscribeInterfaces(bus, std::make_index_sequence<8>{});
+    }
+    Level<4> level4;
+    Level<7> level7;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.publish(level4));
+        benchmark::DoNotOptimize(bus.publish(level7));
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(RttiEventBusPublish)->ThreadRange(1, 8)->UseRealTime();
+
+/// Number of attribute values, alternating between ints and doubles.
+static constexpr std::size_t AttributeCount = 1024;
+
+/// Type-erased value as shown in the README, one allocation and virtual call per value.
+struct AnyVariant {
+    virtual ~AnyVariant() {}
+    virtual RTTI::TypeId valueTypeId() const noexcept = 0;
+};
+
+template <typename T>
+struct Variant : AnyVariant {
+    explicit Variant(T value) : value(value) {}
+
+    RTTI::TypeId valueTypeId() const noexcept override {
+        return RTTI::TypeInfo<T>::Id();
+    }
+
+    T value;
+};
+
+static void
+VariantAttributes(benchmark::State& state) {
+    std::vector<std::unique_ptr<AnyVariant>> attributes(AttributeCount);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            if (i % 2 == 0) {
+                attributes[i] = std::make_unique<Variant<int>>(static_cast<int>(i));
+            } else {
+                attributes[i] = std::make_unique<Variant<double>>(static_cast<double>(i));
+            }
+        }
+        double sum = 0;
+        for (auto const& attribute : attributes) {
+            if (attribute->valueTypeId() == RTTI::TypeInfo<int>::Id()) {
+                sum += static_cast<Variant<int> const&>(*attribute).value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * attributes.size());
+}
+BENCHMARK(VariantAttributes);
+
+static void
+StdAnyAttributes(benchmark::State& state) {
+    std::vector<std::any> attributes(AttributeCount);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            if (i % 2 == 0) {
+                attributes[i] = static_cast<int>(i);
+            } else {
+                attributes[i] = static_cast<double>(i);
+            }
+        }
+        double sum = 0;
+        for (auto const& attribute : attributes) {
+            if (auto const* value = std::any_cast<int>(&attribute)) {
+                sum += *value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * attributes.size());
+}
+BENCHMARK(StdAnyAttributes);
+
+static void
+RttiAnyAttributes(benchmark::State& state) {
+    std::vector<RTTI::Any> attributes(AttributeCount);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            if (i % 2 == 0) {
+                attributes[i] = static_cast<int>(i);
+            } else {
+                attributes[i] = static_cast<double>(i);
+            }
+        }
+        double sum = 0;
+        for (auto const& attribute : attributes) {
+            if (auto const* value = RTTI::any_cast<int>(&attribute)) {
+                sum += *value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * attributes.size());
+}
+BENCHMARK(RttiAnyAttributes);
+
+/// Object shared by all threads of the pointer cast benchmarks.
+struct SharedNode : virtual RTTI::RefCounted {
+    RTTI_DECLARE_TYPEINFO(SharedNode, RTTI::RefCounted);
+};
+
+struct SharedLeaf : SharedNode {
+    RTTI_DECLARE_TYPEINFO(SharedLeaf, SharedNode);
+};
+
+/// Casts a copy of a shared pointer to an object shared by all threads.
+static void
+SharedPtrCopyCast(benchmark::State& state) {
+    static std::shared_ptr<SharedNode> const shared = std::make_shared<SharedLeaf>();
+
+    for (auto _ : state) {
+        auto leaf = RTTI::dynamic_pointer_cast<SharedLeaf>(shared);
+        benchmark::DoNotOptimize(leaf);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SharedPtrCopyCast)->ThreadRange(1, 8)->UseRealTime();
+
+/// Moves the shared pointer of each thread down and back up, which copies before C++20.
+static void
+SharedPtrMoveCast(benchmark::State& state) {
+    static std::shared_ptr<SharedNode> const shared = std::make_shared<SharedLeaf>();
+    auto node = shared;
+
+    for (auto _ : state) {
+        auto leaf = RTTI::dynamic_pointer_cast<SharedLeaf>(std::move(node));
+        benchmark::DoNotOptimize(leaf);
+        node = RTTI::static_pointer_cast<SharedNode>(std::move(leaf));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SharedPtrMoveCast)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+RefCopyCast(benchmark::State& state) {
+    static RTTI::Ref<SharedNode> const shared = RTTI::make_ref<SharedLeaf>();
+
+    for (auto _ : state) {
+        auto leaf = RTTI::dynamic_pointer_cast<SharedLeaf>(shared);
+        benchmark::DoNotOptimize(leaf);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(RefCopyCast)->ThreadRange(1, 8)->UseRealTime();
+
+/// Moves the handle of each thread down and back up, never touching the reference count.
+static void
+RefMoveCast(benchmark::State& state) {
+    static RTTI::Ref<SharedNode> const shared = RTTI::make_ref<SharedLeaf>();
+    auto node = shared;
+
+    for (auto _ : state) {
+        auto leaf = RTTI::dynamic_pointer_cast<SharedLeaf>(std::move(node));
+        benchmark::DoNotOptimize(leaf);
+        node = RTTI::static_pointer_cast<SharedNode>(std::move(leaf));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(RefMoveCast)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * Hand-rolled lookup of the value of the nearest registered ancestor, probing the exact
+ * type first and walking the registered types from the most derived one on otherwise.
+ */
+static void
+UnorderedMapNearest(benchmark::State& state) {
+    auto const objects = MakeMixedObjects(state.range(0));
+    std::unordered_map<RTTI::TypeId, int> const map = {{Level<5>::TypeInfo::Id(), 5},
+                                                       {Level<2>::TypeInfo::Id(), 2}};
+    std::vector<RTTI::TypeId> const walk = {Level<5>::TypeInfo::Id(), Level<2>::TypeInfo::Id()};
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            int const* value = nullptr;
+            if (auto const it = map.find(object->typeId()); it != map.end()) {
+                value = &it->second;
+            } else {
+                for (auto const id : walk) {
+                    if (object->isById(id)) {
+                        value = &map.find(id)->second;
+                        break;
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(UnorderedMapNearest)->Arg(1)->Arg(2)->Arg(8);
+
+static void
+TypeMapNearest(benchmark::State& state) {
+    auto const objects = MakeMixedObjects(state.range(0));
+    RTTI::TypeMap<int> map;
+    map.insert<Level<2>>(2);
+    map.insert<Level<5>>(5);
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            benchmark::DoNotOptimize(map.find_nearest(object.get()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(TypeMapNearest)->Arg(1)->Arg(2)->Arg(8);
+
+/// Lookups of all threads in a single map, memoized by whichever thread resolves first.
+static void
+TypeMapNearestShared(benchmark::State& state) {
+    static RTTI::TypeMap<int> map;
+    static bool const inserted = map.insert<Level<2>>(2) && map.insert<Level<5>>(5);
+    benchmark::DoNotOptimize(inserted);
+    auto const objects = MakeMixedObjects(8);
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            benchmark::DoNotOptimize(map.find_nearest(object.get()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(TypeMapNearestShared)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+FrozenTypeMapNearest(benchmark::State& state) {
+    auto const objects = MakeMixedObjects(state.range(0));
+    static constexpr RTTI::FrozenTypeMap<int, Level<2>, Level<5>> map(2, 5);
+
+    for (auto _ : state) {
+        for (auto const& object : objects) {
+            benchmark::DoNotOptimize(map.find_nearest(object.get()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(FrozenTypeMapNearest)->Arg(1)->Arg(2)->Arg(8);
+
+/// Type names of the passed length, as read from the wire.
+static std::vector<std::string>
+MakeTypeNames(std::size_t length) {
+    std::string const name(RTTI::TypeName<std::vector<std::unique_ptr<Level<7>>>>());
+    std::vector<std::string> names(64);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        while (names[i].size() < length) {
+            names[i] += name;
+        }
+        names[i].resize(length);
+        names[i][i % length] = static_cast<char>('A' + i % 26);
+    }
+    return names;
+}
+
+template <std::uint64_t (*Hash)(std::string_view)>
+static void
+HashTypeNames(benchmark::State& state) {
+    auto const names = MakeTypeNames(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (auto const& name : names) {
+            benchmark::DoNotOptimize(Hash(name));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * names.size() * state.range(0));
+}
+
+static std::uint64_t
+FNV1a(std::string_view name) {
+    return Hash::FNV1a(name);
+}
+
+static std::uint64_t
+FNV1a64(std::string_view name) {
+    return Hash::FNV1a64(name);
+}
+
+static std::uint64_t
+XXH32(std::string_view name) {
+    return Hash::XXH32(name);
+}
+
+static std::uint64_t
+XXH64(std::string_view name) {
+    return Hash::XXH64(name);
+}
+
+BENCHMARK_TEMPLATE(HashTypeNames, FNV1a)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(HashTypeNames, FNV1a64)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(HashTypeNames, XXH32)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(HashTypeNames, XXH64)->Arg(16)->Arg(64)->Arg(256);
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * Sample translation unit used to compare the code and data size of the RTTI modes.
+ * Declares a family of hierarchies and queries each type through a base pointer.
+ */
+#include <rtti.hh>
+
+template <int N>
+struct Node : virtual RTTI::Enable {
+    RTTI_DECLARE_TYPEINFO(Node<N>);
+};
+
+template <int N>
+struct Leaf
+    : Node<N>
+    , Node<N + 16> {
+    RTTI_DECLARE_TYPEINFO(Leaf<N>, Node<N>, Node<N + 16>);
+};
+
+template <int N>
+bool
+Query(RTTI::Enable& object) {
+    return object.typeId() == RTTI::TypeInfo<Leaf<N>>::Id() && object.is<Node<N>>() &&
+           object.cast<Node<N + 16>>() != nullptr;
+}
+
+template <int... Ns>
+int
+QueryAll(std::integer_sequence<int, Ns...>) {
+    int matches = 0;
+    ((matches += [] {
+         Leaf<Ns> leaf;
+         return Query<Ns>(leaf);
+     }()),
+     ...);
+    return matches;
+}
+
+int
+QuerySample() {
+    return QueryAll(std::make_integer_sequence<int, 16>{});
+}
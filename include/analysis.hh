@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "registry.hh"
+#include "rtti.hh"
+#include "type_label.hh"
+
+namespace RTTI {
+    namespace Analysis {
+        /// Shape of a type within its hierarchy and the cost of casting objects of the type.
+        struct Node {
+            TypeId id;
+            std::string_view name;
+
+            /// Identifiers of the direct parents of the type.
+            std::vector<TypeId> parents;
+
+            /// Number of entries in the ancestor table, including the type itself.
+            std::size_t ancestors;
+
+            /// Length of the longest chain of parents to a root, see TypeInfo::Depth().
+            std::size_t depth;
+
+            /// Number of paths to the type and its ancestors, see TypeInfo::Paths().
+            std::size_t paths;
+
+            /// Worst-case number of visited entries, see TypeInfo::NodesVisitedWorstCase().
+            std::size_t worstCase;
+        };
+
+        /**
+         * Hierarchy of a set of types and all of their ancestors, built from the type
+         * descriptors at runtime. Reports the same figures as the constexpr accessors of
+         * TypeInfo, such that a hierarchy can be inspected as a whole.
+         */
+        class Hierarchy {
+        public:
+            /**
+             * Returns the hierarchy of all types registered using RTTI_REGISTER.
+             * @returns Hierarchy of the registered types and their ancestors.
+             */
+            [[nodiscard]] static Hierarchy Registered() {
+                Hierarchy hierarchy;
+                for (auto const* entry : Registry::entries()) {
+                    hierarchy.add(*entry->descriptor);
+                }
+                return hierarchy;
+            }
+
+            /**
+             * Adds the described type and all of its ancestors to the hierarchy.
+             * @param descriptor The descriptor of the type.
+             * @returns The index of the node of the type in nodes(), which stays valid as
+             * further types are added.
+             */
+            std::size_t add(Detail::TypeDescriptor const& descriptor) {
+                return insert(descriptor);
+            }
+
+            /// Adds the passed types and all of their ancestors to the hierarchy.
+            template <typename... Ts>
+            void add() {
+                (add(Ts::TypeInfo::Descriptor()), ...);
+            }
+
+            /**
+             * Finds the node of the type identified by the passed type id.
+             * @returns Node of the type, nullptr if not part of the hierarchy.
+             */
+            [[nodiscard]] Node const* find(TypeId typeId) const noexcept {
+                auto const it = _indices.find(typeId);
+                return it != _indices.end() ? &_nodes[it->second] : nullptr;
+            }
+
+            /// Returns the nodes of all types, each type following its parents.
+            [[nodiscard]] std::vector<Node> const& nodes() const noexcept {
+                return _nodes;
+            }
+
+            /**
+             * Exports the hierarchy as a Graphviz digraph with an edge from each type to each
+             * of its parents. Types whose casts visit more than a single entry are colored red.
+             * @returns The DOT document.
+             */
+            [[nodiscard]] std::string toDot() const {
+                std::string dot = "digraph rtti {\n    rankdir=BT;\n    node [shape=box];\n";
+                for (auto const* node : sorted()) {
+                    dot += "    ";
+                    AppendLabel(dot, *node);
+                    dot += " [label=\"";
+                    Detail::AppendEscaped(dot, node->name);
+                    dot += "\\ndepth " + std::to_string(node->depth) + ", ancestors " +
+                           std::to_string(node->ancestors) + ", paths " +
+                           std::to_string(node->paths) + "\\nworst case " +
+                           std::to_string(node->worstCase) + "\"";
+                    dot += node->worstCase > 1 ? ", color=red];\n" : "];\n";
+                    for (auto const parent : node->parents) {
+                        dot += "    ";
+                        AppendLabel(dot, *node);
+                        dot += " -> ";
+                        AppendLabel(dot, *find(parent));
+                        dot += ";\n";
+                    }
+                }
+                dot += "}\n";
+                return dot;
+            }
+
+            /**
+             * Exports the hierarchy as a JSON object holding a type entry per type, sorted
+             * by name. Types without a name are labeled by their identifier.
+             * @returns The JSON document.
+             */
+            [[nodiscard]] std::string toJson() const {
+                std::string json = "{\"types\":[";
+                auto const nodes = sorted();
+                for (std::size_t i = 0; i < nodes.size(); ++i) {
+                    auto const& node = *nodes[i];
+                    json += i > 0 ? ",{" : "{";
+                    json += "\"name\":";
+                    AppendLabel(json, node);
+                    json += ",\"parents\":[";
+                    for (std::size_t j = 0; j < node.parents.size(); ++j) {
+                        json += j > 0 ? "," : "";
+                        AppendLabel(json, *find(node.parents[j]));
+                    }
+                    json += "],\"ancestors\":" + std::to_string(node.ancestors);
+                    json += ",\"depth\":" + std::to_string(node.depth);
+                    json += ",\"paths\":" + std::to_string(node.paths);
+                    json += ",\"worstCase\":" + std::to_string(node.worstCase) + "}";
+                }
+                json += "]}";
+                return json;
+            }
+
+        private:
+            std::size_t insert(Detail::TypeDescriptor const& descriptor) {
+                if (auto const it = _indices.find(descriptor.id); it != _indices.end()) {
+                    return it->second;
+                }
+
+                Node node{descriptor.id, descriptor.name, {}, descriptor.size, 0, 1,
+                          descriptor.probes(descriptor.size)};
+                for (std::size_t i = 0; i < descriptor.parentCount; ++i) {
+                    auto const& parent = _nodes[insert(*descriptor.parents[i])];
+                    node.parents.push_back(parent.id);
+                    node.depth = std::max(node.depth, parent.depth + 1);
+                    node.paths += parent.paths;
+                }
+                _indices.emplace(node.id, _nodes.size());
+                _nodes.push_back(std::move(node));
+                return _nodes.size() - 1;
+            }
+
+            [[nodiscard]] std::vector<Node const*> sorted() const {
+                std::vector<Node const*> nodes;
+                for (auto const& node : _nodes) {
+                    nodes.push_back(&node);
+                }
+                std::sort(nodes.begin(), nodes.end(), [](Node const* a, Node const* b) {
+                    return a->name != b->name ? a->name < b->name : a->id < b->id;
+                });
+                return nodes;
+            }
+
+            /// Appends the quoted name of the node, its identifier in case it has no name.
+            static void AppendLabel(std::string& out, Node const& node) {
+                Detail::AppendTypeLabel(out, node.id, node.name);
+            }
+
+            std::vector<Node> _nodes;
+            std::unordered_map<TypeId, std::size_t> _indices;
+        };
+    }  // namespace Analysis
+}  // namespace RTTI
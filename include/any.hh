@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /**
+         * Operations on a value of a single type stored by RTTI::BasicAny, either inline in
+         * the buffer of the any or on the heap with the buffer holding the pointer. Each
+         * stored type has its own operations, so their address identifies the type.
+         */
+        struct AnyOps {
+            /// Whether the value is copied, relocated and destroyed bytewise.
+            bool trivial;
+
+            /// Copy constructs the value of source into the empty buffer target.
+            void (*copy)(void* target, void const* source);
+
+            /// Move constructs the value of source into target and destroys the source.
+            void (*relocate)(void* target, void* source) noexcept;
+
+            void (*destroy)(void* buffer) noexcept;
+
+            /// Returns the RTTI::Enable base of the value, nullptr if it has none.
+            Enable* (*enable)(void* buffer) noexcept;
+        };
+
+        template <typename T, bool Inline>
+        struct AnyStorage {
+            static T* Get(void* buffer) noexcept {
+                if constexpr (Inline) {
+                    return std::launder(static_cast<T*>(buffer));
+                } else {
+                    return *static_cast<T**>(buffer);
+                }
+            }
+
+            static void Copy(void* target, void const* source) {
+                auto const& value = *Get(const_cast<void*>(source));
+                if constexpr (Inline) {
+                    ::new (target) T(value);
+                } else {
+                    *static_cast<T**>(target) = new T(value);
+                }
+            }
+
+            static void Relocate(void* target, void* source) noexcept {
+                if constexpr (Inline) {
+                    ::new (target) T(std::move(*Get(source)));
+                    Get(source)->~T();
+                } else {
+                    *static_cast<T**>(target) = Get(source);
+                }
+            }
+
+            static void Destroy(void* buffer) noexcept {
+                if constexpr (Inline) {
+                    Get(buffer)->~T();
+                } else {
+                    delete Get(buffer);
+                }
+            }
+
+            static Enable* GetEnable(void* buffer) noexcept {
+                if constexpr (std::is_base_of_v<Enable, T>) {
+                    return Get(buffer);
+                } else {
+                    return nullptr;
+                }
+            }
+
+            static constexpr auto CopyFunction() noexcept {
+                if constexpr (std::is_copy_constructible_v<T>) {
+                    return &Copy;
+                } else {
+                    return static_cast<decltype(&Copy)>(nullptr);
+                }
+            }
+
+            static constexpr bool Trivial = Inline && std::is_trivially_copyable_v<T>;
+
+            static constexpr AnyOps Ops = {Trivial, CopyFunction(), &Relocate, &Destroy,
+                                           &GetEnable};
+        };
+
+        /**
+         * Storage of a type-erased value, the value is stored inline in the buffer or on
+         * the heap with the buffer holding the pointer. Trivially copyable values stored
+         * inline are copied bytewise without calling their operations.
+         */
+        template <std::size_t Size>
+        class AnyValue {
+            static_assert(Size >= sizeof(void*),
+                          "The inline buffer must be able to hold a pointer.");
+
+        public:
+            static constexpr std::size_t Align = alignof(std::max_align_t);
+
+            /// Checks whether values of the type T are stored without allocation.
+            template <typename T>
+            static constexpr bool StoresInline = sizeof(T) <= Size && alignof(T) <= Align &&
+                                                 std::is_nothrow_move_constructible_v<T>;
+
+            AnyValue() noexcept = default;
+
+            AnyValue(AnyValue const& other) {
+                if (other._ops != nullptr && !other._ops->trivial) {
+                    other._ops->copy(_buffer, other._buffer);
+                } else {
+                    std::memcpy(_buffer, other._buffer, Size);
+                }
+                _ops = other._ops;
+                _typeId = other._typeId;
+            }
+
+            AnyValue(AnyValue&& other) noexcept {
+                moveFrom(other);
+            }
+
+            ~AnyValue() {
+                reset();
+            }
+
+            AnyValue& operator=(AnyValue const& other) {
+                if (this != &other) {
+                    AnyValue copy(other);
+                    reset();
+                    moveFrom(copy);
+                }
+                return *this;
+            }
+
+            AnyValue& operator=(AnyValue&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    moveFrom(other);
+                }
+                return *this;
+            }
+
+            template <typename T, typename... Args>
+            T& emplace(Args&&... args) {
+                reset();
+                T* value;
+                if constexpr (StoresInline<T>) {
+                    value = ::new (static_cast<void*>(_buffer)) T(std::forward<Args>(args)...);
+                } else {
+                    value = new T(std::forward<Args>(args)...);
+                    ::new (static_cast<void*>(_buffer)) T*(value);
+                }
+                _ops = &Storage<T>::Ops;
+                _typeId = TypeInfo<T>::Id();
+                return *value;
+            }
+
+            void reset() noexcept {
+                if (_ops != nullptr && !_ops->trivial) {
+                    _ops->destroy(_buffer);
+                }
+                _ops = nullptr;
+                _typeId = Empty;
+            }
+
+            [[nodiscard]] bool has_value() const noexcept {
+                return _typeId != Empty;
+            }
+
+            [[nodiscard]] TypeId typeId() const noexcept {
+                return _typeId;
+            }
+
+            /**
+             * Checks whether the value is exactly of the type T. Matching type identifiers
+             * are confirmed by the operations of the type, as hashed identifiers may collide.
+             */
+            template <typename T>
+            [[nodiscard]] bool holds() const noexcept {
+                if constexpr (std::is_void_v<T>) {
+                    return !has_value();
+                } else {
+                    return _typeId == TypeInfo<T>::Id() && _ops == &Storage<T>::Ops;
+                }
+            }
+
+            template <typename T>
+            [[nodiscard]] T* get() noexcept {
+                if (holds<T>()) {
+                    return Storage<T>::Get(_buffer);
+                }
+                if constexpr (std::is_base_of_v<Enable, T> && !std::is_final_v<T>) {
+                    if (_ops != nullptr) {
+                        if (auto* enable = _ops->enable(_buffer)) {
+                            return RTTI::cast<T>(enable);
+                        }
+                    }
+                }
+                return nullptr;
+            }
+
+        private:
+            static constexpr TypeId Empty = TypeInfo<void>::Id();
+
+            template <typename T>
+            using Storage = AnyStorage<T, StoresInline<T>>;
+
+            void moveFrom(AnyValue& other) noexcept {
+                if (other._ops != nullptr && !other._ops->trivial) {
+                    other._ops->relocate(_buffer, other._buffer);
+                } else {
+                    std::memcpy(_buffer, other._buffer, Size);
+                }
+                _ops = std::exchange(other._ops, nullptr);
+                _typeId = std::exchange(other._typeId, Empty);
+            }
+
+            TypeId _typeId = Empty;
+            AnyOps const* _ops = nullptr;
+            alignas(Align) unsigned char _buffer[Size];
+        };
+
+        /// Deletes the copy operations of move-only anys.
+        template <bool Copyable>
+        struct AnyCopyPolicy {};
+
+        template <>
+        struct AnyCopyPolicy<false> {
+            AnyCopyPolicy() = default;
+            AnyCopyPolicy(AnyCopyPolicy const&) = delete;
+            AnyCopyPolicy(AnyCopyPolicy&&) = default;
+            AnyCopyPolicy& operator=(AnyCopyPolicy const&) = delete;
+            AnyCopyPolicy& operator=(AnyCopyPolicy&&) = default;
+        };
+    }  // namespace Detail
+
+    /**
+     * Type-erased value identified by the type identifier of its type. Values of types
+     * that fit the inline buffer and are nothrow move constructible are stored inline
+     * without allocation, others are allocated on the heap. Trivially copyable values
+     * stored inline are copied without any indirect call. Checking the type of the value
+     * costs a comparison of type identifiers, confirmed by comparing the address of the
+     * operations of the type. Values of RTTI enabled class types can also be accessed as
+     * any of their ancestors.
+     * @tparam Size Size of the inline buffer in bytes.
+     * @tparam Copyable Whether the any is copyable, which requires copyable values.
+     */
+    template <std::size_t Size, bool Copyable>
+    class BasicAny
+        : Detail::AnyValue<Size>
+        , Detail::AnyCopyPolicy<Copyable> {
+        using Value = Detail::AnyValue<Size>;
+
+        template <typename T>
+        using EnableIfValue = std::enable_if_t<!std::is_same_v<std::decay_t<T>, BasicAny> &&
+                                               !std::is_same_v<std::decay_t<T>, Value>>;
+
+    public:
+        /// Checks whether values of the type T are stored without allocation.
+        template <typename T>
+        static constexpr bool StoresInline = Value::template StoresInline<T>;
+
+        /// Constructs an empty any.
+        BasicAny() noexcept = default;
+
+        /// Constructs an any holding the passed value.
+        template <typename T, typename = EnableIfValue<T>>
+        BasicAny(T&& value) {
+            emplace<std::decay_t<T>>(std::forward<T>(value));
+        }
+
+        /// Constructs an any holding a value of the type T constructed from the arguments.
+        template <typename T, typename... Args>
+        explicit BasicAny(std::in_place_type_t<T>, Args&&... args) {
+            emplace<T>(std::forward<Args>(args)...);
+        }
+
+        template <typename T, typename = EnableIfValue<T>>
+        BasicAny& operator=(T&& value) {
+            emplace<std::decay_t<T>>(std::forward<T>(value));
+            return *this;
+        }
+
+        /**
+         * Replaces the value by a value of the type T constructed from the arguments.
+         * @returns Reference to the new value.
+         */
+        template <typename T, typename... Args>
+        T& emplace(Args&&... args) {
+            static_assert(std::is_same_v<T, std::decay_t<T>>,
+                          "Anys hold values, not references, arrays or functions.");
+            static_assert(!Copyable || std::is_copy_constructible_v<T>,
+                          "Copyable anys require copy constructible values, use RTTI::UniqueAny.");
+            return Value::template emplace<T>(std::forward<Args>(args)...);
+        }
+
+        /// Destroys the value, if any.
+        using Value::reset;
+
+        void swap(BasicAny& other) noexcept {
+            std::swap(*this, other);
+        }
+
+        using Value::has_value;
+
+        /// Returns the type identifier of the value, that of void in case of an empty any.
+        using Value::typeId;
+
+        /// Checks whether the value is exactly of the type T.
+        template <typename T>
+        [[nodiscard]] bool is() const noexcept {
+            return Value::template holds<std::remove_cv_t<T>>();
+        }
+
+        /**
+         * Returns a pointer to the value as the type T. Values of RTTI enabled class types
+         * are also accessible as any of their ancestors.
+         * @returns Pointer to the value, nullptr if the value is not a T.
+         */
+        template <typename T>
+        [[nodiscard]] T* get() noexcept {
+            static_assert(!std::is_reference_v<T>, "Values can not be accessed by reference type.");
+            return Value::template get<std::remove_cv_t<T>>();
+        }
+
+        template <typename T>
+        [[nodiscard]] T const* get() const noexcept {
+            return const_cast<BasicAny*>(this)->template get<T>();
+        }
+    };
+
+    /// Copyable any storing values up to 16 bytes inline.
+    using Any = BasicAny<16, true>;
+
+    /// Move-only any storing values up to 16 bytes inline, accepting move-only values.
+    using UniqueAny = BasicAny<16, false>;
+
+    /**
+     * Returns a pointer to the value of the any as the type T.
+     * @returns Pointer to the value, nullptr if the any is empty, a nullptr or does not
+     * hold a T.
+     */
+    template <typename T, std::size_t Size, bool Copyable>
+    [[nodiscard]] T* any_cast(BasicAny<Size, Copyable>* any) noexcept {
+        return any != nullptr ? any->template get<T>() : nullptr;
+    }
+
+    template <typename T, std::size_t Size, bool Copyable>
+    [[nodiscard]] T const* any_cast(BasicAny<Size, Copyable> const* any) noexcept {
+        return any != nullptr ? any->template get<T>() : nullptr;
+    }
+}  // namespace RTTI
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "rtti.hh"
+
+#if !defined(RTTI_DISABLE_SIMD) && defined(__AVX2__)
+    #include <immintrin.h>
+    #define RTTI_DETAIL_SIMD_AVX2
+#elif !defined(RTTI_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define RTTI_DETAIL_SIMD_SSE2
+    #if defined(__SSE4_1__)
+        #include <smmintrin.h>
+        #define RTTI_DETAIL_SIMD_SSE41
+    #endif
+#endif
+
+namespace RTTI {
+    namespace Detail {
+        /// Hints the processor to fetch the cache line at the passed address for reading.
+        inline void Prefetch([[maybe_unused]] void const* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(ptr);
+#endif
+        }
+
+        /**
+         * Comparison kernel for vectors of type identifiers of the type Id. The generic
+         * kernel processes a single identifier at a time, specializations use the
+         * available SIMD instruction set to compare several at once.
+         */
+        template <typename Id>
+        struct IdKernel {
+            using Vector = Id;
+            static constexpr std::size_t Lanes = 1;
+
+            [[nodiscard]] static Vector Load(Id const* ids) noexcept {
+                return ids[0];
+            }
+
+            [[nodiscard]] static Vector Broadcast(Id typeId) noexcept {
+                return typeId;
+            }
+
+            [[nodiscard]] static std::uint32_t MatchAny(Vector values, Vector const* set,
+                                                        std::size_t size) noexcept {
+                bool any = false;
+                for (std::size_t k = 0; k < size; ++k) {
+                    any |= values == set[k];
+                }
+                return any ? 1u : 0u;
+            }
+        };
+
+#if defined(RTTI_DETAIL_SIMD_AVX2)
+        template <>
+        struct IdKernel<std::uint32_t> {
+            using Vector = __m256i;
+            static constexpr std::size_t Lanes = 8;
+
+            [[nodiscard]] static Vector Load(std::uint32_t const* ids) noexcept {
+                return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ids));
+            }
+
+            [[nodiscard]] static Vector Broadcast(std::uint32_t typeId) noexcept {
+                return _mm256_set1_epi32(static_cast<std::int32_t>(typeId));
+            }
+
+            [[nodiscard]] static std::uint32_t MatchAny(Vector values, Vector const* set,
+                                                        std::size_t size) noexcept {
+                auto any = _mm256_setzero_si256();
+                for (std::size_t k = 0; k < size; ++k) {
+                    any = _mm256_or_si256(any, _mm256_cmpeq_epi32(values, set[k]));
+                }
+                return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(any)));
+            }
+        };
+
+        template <>
+        struct IdKernel<std::uint64_t> {
+            using Vector = __m256i;
+            static constexpr std::size_t Lanes = 4;
+
+            [[nodiscard]] static Vector Load(std::uint64_t const* ids) noexcept {
+                return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ids));
+            }
+
+            [[nodiscard]] static Vector Broadcast(std::uint64_t typeId) noexcept {
+                return _mm256_set1_epi64x(static_cast<std::int64_t>(typeId));
+            }
+
+            [[nodiscard]] static std::uint32_t MatchAny(Vector values, Vector const* set,
+                                                        std::size_t size) noexcept {
+                auto any = _mm256_setzero_si256();
+                for (std::size_t k = 0; k < size; ++k) {
+                    any = _mm256_or_si256(any, _mm256_cmpeq_epi64(values, set[k]));
+                }
+                return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(any)));
+            }
+        };
+#elif defined(RTTI_DETAIL_SIMD_SSE2)
+        template <>
+        struct IdKernel<std::uint32_t> {
+            using Vector = __m128i;
+            static constexpr std::size_t Lanes = 4;
+
+            [[nodiscard]] static Vector Load(std::uint32_t const* ids) noexcept {
+                return _mm_loadu_si128(reinterpret_cast<__m128i const*>(ids));
+            }
+
+            [[nodiscard]] static Vector Broadcast(std::uint32_t typeId) noexcept {
+                return _mm_set1_epi32(static_cast<std::int32_t>(typeId));
+            }
+
+            [[nodiscard]] static std::uint32_t MatchAny(Vector values, Vector const* set,
+                                                        std::size_t size) noexcept {
+                auto any = _mm_setzero_si128();
+                for (std::size_t k = 0; k < size; ++k) {
+                    any = _mm_or_si128(any, _mm_cmpeq_epi32(values, set[k]));
+                }
+                return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(any)));
+            }
+        };
+
+    #if defined(RTTI_DETAIL_SIMD_SSE41)
+        template <>
+        struct IdKernel<std::uint64_t> {
+            using Vector = __m128i;
+            static constexpr std::size_t Lanes = 2;
+
+            [[nodiscard]] static Vector Load(std::uint64_t const* ids) noexcept {
+                return _mm_loadu_si128(reinterpret_cast<__m128i const*>(ids));
+            }
+
+            [[nodiscard]] static Vector Broadcast(std::uint64_t typeId) noexcept {
+                return _mm_set1_epi64x(static_cast<std::int64_t>(typeId));
+            }
+
+            [[nodiscard]] static std::uint32_t MatchAny(Vector values, Vector const* set,
+                                                        std::size_t size) noexcept {
+                auto any = _mm_setzero_si128();
+                for (std::size_t k = 0; k < size; ++k) {
+                    any = _mm_or_si128(any, _mm_cmpeq_epi64(values, set[k]));
+                }
+                return static_cast<std::uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(any)));
+            }
+        };
+    #endif
+#endif
+
+        /// Kernel for the configured type identifiers.
+        using Kernel = IdKernel<TypeId>;
+
+        /// Number of objects ahead of the current one that are prefetched while gathering.
+        constexpr std::size_t PrefetchDistance = 16;
+
+        /// Number of objects gathered and classified at once.
+        constexpr std::size_t BatchBlockSize = 256;
+
+        /// Returns the index of the lowest set bit of a non-zero mask.
+        [[nodiscard]] inline unsigned LowestBit(std::uint32_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+            unsigned bit = 0;
+            while ((mask & 1) == 0) {
+                mask >>= 1;
+                ++bit;
+            }
+            return bit;
+#endif
+        }
+
+        /// Returns the number of set bits in the mask.
+        [[nodiscard]] inline unsigned PopCount(std::uint32_t mask) noexcept {
+#if defined(__POPCNT__)
+            return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+            // Avoid the library call emitted for __builtin_popcount without POPCNT.
+            mask = mask - ((mask >> 1) & 0x55555555u);
+            mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+            return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+        }
+
+        /**
+         * Gathers the type identifiers of the passed objects, prefetching the objects
+         * ahead such that the loads of their virtual tables overlap.
+         */
+        template <typename U>
+        void GatherTypeIds(U const* const* objects, std::size_t count, TypeId* ids) noexcept {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i + PrefetchDistance < count) {
+                    Prefetch(objects[i + PrefetchDistance]);
+                }
+                ids[i] = objects[i]->typeId();
+            }
+        }
+
+        /**
+         * Maps the dynamic types seen during a batch operation onto groups. As the group of
+         * an object only depends on its dynamic type, each distinct type identifier is
+         * resolved using the scalar type checks once, after which all objects of that type
+         * are classified by comparing type identifiers only.
+         * @tparam Groups Number of groups, the group Groups holds objects matching none.
+         */
+        template <std::size_t Groups>
+        struct LearnedTypeIds {
+            /// Maximum number of remembered types, further types are resolved each time.
+            static constexpr std::size_t Capacity = 32;
+
+            /// Broadcasted known identifiers ordered by group, those of group g are in the
+            /// range [bounds[g], bounds[g + 1]).
+            Kernel::Vector ids[Capacity];
+            std::array<std::size_t, Groups + 2> bounds{};
+
+            void learn(TypeId typeId, std::size_t group) noexcept {
+                if (bounds[Groups + 1] < Capacity) {
+                    for (auto k = bounds[Groups + 1]; k > bounds[group + 1]; --k) {
+                        ids[k] = ids[k - 1];
+                    }
+                    ids[bounds[group + 1]] = Kernel::Broadcast(typeId);
+                    for (auto g = group + 1; g < bounds.size(); ++g) {
+                        ++bounds[g];
+                    }
+                }
+            }
+
+            /**
+             * Classifies a block of gathered type identifiers.
+             * @param typeIds The type identifiers of the objects.
+             * @param count Number of objects in the block.
+             * @param resolve Called with the index of an object of an unknown type,
+             * returns its group.
+             * @param match Called with the index of the first object of a chunk of lanes,
+             * a possibly empty bit mask of the objects in the chunk and their group.
+             */
+            template <typename Resolve, typename Match>
+            void classify(TypeId const* typeIds, std::size_t count, Resolve&& resolve,
+                          Match&& match) {
+                constexpr auto all =
+                    static_cast<std::uint32_t>((std::uint64_t{1} << Kernel::Lanes) - 1);
+
+                std::size_t i = 0;
+                for (; i + Kernel::Lanes <= count; i += Kernel::Lanes) {
+                    classifyChunk(typeIds + i, i, all, resolve, match);
+                }
+                if (i < count) {
+                    // Pad the remaining objects to a full chunk, masking out the padding.
+                    std::array<TypeId, Kernel::Lanes> tail{};
+                    std::copy(typeIds + i, typeIds + count, tail.begin());
+                    auto const valid = static_cast<std::uint32_t>((1u << (count - i)) - 1);
+                    classifyChunk(tail.data(), i, valid, resolve, match);
+                }
+            }
+
+        private:
+            template <typename Resolve, typename Match>
+            void classifyChunk(TypeId const* typeIds, std::size_t first, std::uint32_t pending,
+                               Resolve& resolve, Match& match) {
+                auto const values = Kernel::Load(typeIds);
+                // Matching all groups without branching on the masks avoids mispredictions
+                // for objects of randomly mixed types.
+                for (std::size_t group = 0; group <= Groups; ++group) {
+                    auto const mask = Kernel::MatchAny(values, ids + bounds[group],
+                                                       bounds[group + 1] - bounds[group]) &
+                                      pending;
+                    match(first, mask, group);
+                    pending &= ~mask;
+                }
+                while (pending != 0) {
+                    auto const lane = LowestBit(pending);
+                    auto const group = resolve(first + lane);
+                    learn(typeIds[lane], group);
+                    auto const typeId = Kernel::Broadcast(typeIds[lane]);
+                    auto const mask = Kernel::MatchAny(values, &typeId, 1) & pending;
+                    match(first, mask, group);
+                    pending &= ~mask;
+                }
+            }
+        };
+
+        /// Returns the index of the first of the types Ts the object is an instance of.
+        template <typename... Ts, typename U>
+        [[nodiscard]] std::size_t FirstMatchingType(U const* ptr) noexcept {
+            std::size_t group = 0;
+            ((RTTI::is<Ts>(ptr) || (++group, false)) || ...);
+            return group;
+        }
+    }  // namespace Detail
+
+    /**
+     * Gathers the type identifiers of the most specialized types of the passed objects.
+     * @param objects Pointers to the objects, may not contain a nullptr.
+     * @param count Number of objects.
+     * @param ids Receives the type identifier of each object.
+     */
+    template <typename U>
+    void classify(U const* const* objects, std::size_t count, TypeId* ids) noexcept {
+        Detail::GatherTypeIds(objects, count, ids);
+    }
+
+    template <typename Container>
+    auto classify(Container const& objects, TypeId* ids) noexcept
+        -> decltype(classify(std::data(objects), std::size(objects), ids)) {
+        classify(std::data(objects), std::size(objects), ids);
+    }
+
+    /**
+     * Counts the objects that are an instance or child instance of the passed type.
+     * Objects are processed in blocks: their type identifiers are gathered and compared,
+     * several at a time, against the identifiers of the dynamic types seen so far. Only
+     * the first object of each dynamic type is checked using RTTI::is. Checks against
+     * final types are a single comparison per object.
+     *
+     * @tparam T The type to check for.
+     * @param objects Pointers to the objects, may not contain a nullptr.
+     * @param count Number of objects.
+     * @returns Number of objects that are an instance of the passed type.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] std::size_t count_is(U const* const* objects, std::size_t count) noexcept {
+        if constexpr (std::is_base_of_v<T, U> && Detail::IsStaticCastable<U, T>::value) {
+            return count;
+        } else {
+            std::array<TypeId, Detail::BatchBlockSize> ids;
+            Detail::LearnedTypeIds<1> learned;
+            if constexpr (std::is_final_v<T>) {
+                learned.learn(TypeInfo<T>::Id(), 0);
+            }
+
+            std::size_t matches = 0;
+            for (std::size_t first = 0; first < count; first += Detail::BatchBlockSize) {
+                auto const block = std::min(count - first, Detail::BatchBlockSize);
+                auto const* const objs = objects + first;
+                Detail::GatherTypeIds(objs, block, ids.data());
+                learned.classify(
+                    ids.data(), block,
+                    [objs](std::size_t i) -> std::size_t {
+                        if constexpr (std::is_final_v<T>) {
+                            return 1;
+                        } else {
+                            return RTTI::is<T>(objs[i]) ? 0 : 1;
+                        }
+                    },
+                    [&matches](std::size_t, std::uint32_t mask, std::size_t group) {
+                        matches += group == 0 ? Detail::PopCount(mask) : 0;
+                    });
+            }
+            return matches;
+        }
+    }
+
+    template <typename T, typename Container>
+    [[nodiscard]] auto count_is(Container const& objects) noexcept
+        -> decltype(count_is<T>(std::data(objects), std::size(objects))) {
+        return count_is<T>(std::data(objects), std::size(objects));
+    }
+
+    /**
+     * Reorders the passed objects by type: first the instances of the first of the passed
+     * types, followed by the instances of the second one and so on, with the remaining
+     * objects at the end. Objects that are an instance of several of the passed types are
+     * placed with the first one. The relative order of the objects in each group is
+     * preserved. Objects are classified in blocks the same way as by count_is.
+     *
+     * @tparam Ts The types to partition the objects by.
+     * @param objects Pointers to the objects, may not contain a nullptr.
+     * @param count Number of objects.
+     * @returns The end index of the group of each of the passed types.
+     */
+    template <typename... Ts, typename U>
+    std::array<std::size_t, sizeof...(Ts)> partition_by_type(U** objects, std::size_t count) {
+        constexpr std::size_t Groups = sizeof...(Ts);
+        static_assert(Groups > 0, "At least one type to partition by is required.");
+        static_assert(Groups < 255, "Too many types to partition by.");
+
+        std::vector<std::uint8_t> groups(count);
+        std::array<std::size_t, Groups + 1> sizes{};
+        std::array<TypeId, Detail::BatchBlockSize> ids;
+        Detail::LearnedTypeIds<Groups> learned;
+
+        for (std::size_t first = 0; first < count; first += Detail::BatchBlockSize) {
+            auto const block = std::min(count - first, Detail::BatchBlockSize);
+            U const* const* const objs = objects + first;
+            auto* const out = groups.data() + first;
+            Detail::GatherTypeIds(objs, block, ids.data());
+            learned.classify(
+                ids.data(), block,
+                [objs](std::size_t i) { return Detail::FirstMatchingType<Ts...>(objs[i]); },
+                [out, &sizes](std::size_t i, std::uint32_t mask, std::size_t group) {
+                    sizes[group] += Detail::PopCount(mask);
+                    for (; mask != 0; mask &= mask - 1) {
+                        out[i + Detail::LowestBit(mask)] = static_cast<std::uint8_t>(group);
+                    }
+                });
+        }
+
+        std::array<std::size_t, Groups + 1> offsets{};
+        for (std::size_t group = 1; group <= Groups; ++group) {
+            offsets[group] = offsets[group - 1] + sizes[group - 1];
+        }
+        std::array<std::size_t, Groups> ends{};
+        for (std::size_t group = 0; group < Groups; ++group) {
+            ends[group] = offsets[group + 1];
+        }
+
+        std::vector<U*> sorted(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            sorted[offsets[groups[i]]++] = objects[i];
+        }
+        std::copy(sorted.begin(), sorted.end(), objects);
+        return ends;
+    }
+
+    template <typename... Ts, typename Container>
+    auto partition_by_type(Container& objects)
+        -> decltype(partition_by_type<Ts...>(std::data(objects), std::size(objects))) {
+        return partition_by_type<Ts...>(std::data(objects), std::size(objects));
+    }
+}  // namespace RTTI
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "id_slot.hh"
+#include "rtti.hh"
+
+namespace RTTI {
+    /**
+     * Small polymorphic inline cache for a single cast call site. Maps the type identifiers
+     * of the most recently seen dynamic types onto the pointer adjustment of the cast, or a
+     * cached miss. Each entry is an atomic Detail::IdSlot such that concurrent lookups and
+     * updates never observe a torn entry. Once the entries have been replaced
+     * many times the call site is considered megamorphic and the cache is bypassed. The
+     * cache is constant initialized and never allocates.
+     * @tparam T Type the objects are cast into, without const.
+     * @tparam U Type of the pointers cast, without const. The adjustments depend on both,
+     * hence a cache can only be used for the cast it was declared for.
+     * @tparam Ways Number of dynamic types remembered by the cache.
+     */
+    template <typename T, typename U, std::size_t Ways = 4>
+    struct CastCache {
+        static_assert(Ways > 0, "A cast cache requires at least one entry.");
+
+        /// Adjustments are stored in 31 bits, the lowest representable value marks a miss.
+        static constexpr std::int32_t MaxOffset = (INT32_C(1) << 29);
+        static constexpr std::int32_t Miss = -(INT32_C(1) << 30);
+
+        /// Number of insertions after which the call site is considered megamorphic.
+        static constexpr std::uint32_t MegamorphicThreshold = 16 * Ways;
+
+        /**
+         * Checks whether the call site has seen too many distinct dynamic types for the
+         * cache to be effective.
+         * @returns True in case the cache should be bypassed.
+         */
+        [[nodiscard]] bool megamorphic() const noexcept {
+            return next.load(std::memory_order_relaxed) >= MegamorphicThreshold;
+        }
+
+        /**
+         * Looks up the adjustment cached for the passed dynamic type.
+         * @param typeId The identifier of the dynamic type of the object.
+         * @param offset Set to the cached adjustment, or Miss, in case found.
+         * @returns True in case the dynamic type was found in the cache.
+         */
+        [[nodiscard]] bool find(TypeId typeId, std::int32_t& offset) const noexcept {
+            for (auto const& entry : entries) {
+                std::uint32_t value;
+                if (entry.load(typeId, value)) {
+                    offset = static_cast<std::int32_t>(value) >> 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Stores the adjustment for the passed dynamic type, replacing entries in a round
+         * robin fashion. Adjustments which do not fit an entry are not cached.
+         * @param typeId The identifier of the dynamic type of the object.
+         * @param offset The adjustment of the cast, or Miss.
+         */
+        void insert(TypeId typeId, std::ptrdiff_t offset) noexcept {
+            if (offset != Miss && (offset <= -MaxOffset || offset >= MaxOffset)) {
+                return;
+            }
+            auto const encoded = (static_cast<std::uint32_t>(offset) << 1) | 1;
+            auto const way = next.fetch_add(1, std::memory_order_relaxed) % Ways;
+            entries[way].store(typeId, encoded);
+        }
+
+        std::array<Detail::IdSlot<>, Ways> entries{};
+        std::atomic<std::uint32_t> next{0};
+    };
+
+    /**
+     * Dynamically cast the passed object to the passed type using the passed inline cache.
+     * On a cache hit the cast costs a single read of the type identifier of the object,
+     * a comparison and a pointer adjustment. On a miss the cast is resolved using
+     * RTTI::cast and the result is stored in the cache, unless the call site turned out
+     * to be megamorphic. The cache relies on all objects of the same dynamic type sharing
+     * the same layout, hence each type in the hierarchy has to declare its type
+     * information.
+     *
+     * @tparam T Type to cast the object into.
+     * @param ptr Pointer to the object, may be a nullptr.
+     * @param cache The cache of the call site.
+     * @returns A valid pointer to an instance of the passed type. Nullptr incase the
+     * object instance is not a direct descendence of the passed type.
+     */
+    template <typename T, typename U, std::size_t Ways>
+    [[nodiscard]] Detail::CastResult<T, U> CachedCast(
+        U* ptr, CastCache<std::remove_const_t<T>, std::remove_const_t<U>, Ways>& cache) noexcept {
+        using Result = Detail::CastResult<T, U>;
+        using Byte = std::conditional_t<std::is_const_v<U>, char const, char>;
+
+        if constexpr (std::is_base_of_v<T, U> &&
+                      Detail::IsStaticCastable<U const, T const>::value) {
+            return static_cast<Result>(ptr);
+        } else {
+            if (ptr == nullptr) {
+                return nullptr;
+            }
+            if (cache.megamorphic()) {
+                return RTTI::cast<T>(ptr);
+            }
+
+            auto const typeId = ptr->typeId();
+            std::int32_t offset;
+            if (cache.find(typeId, offset)) {
+                return offset == cache.Miss
+                           ? nullptr
+                           : reinterpret_cast<Result>(reinterpret_cast<Byte*>(ptr) + offset);
+            }
+
+            auto const result = RTTI::cast<T>(ptr);
+            cache.insert(typeId, result == nullptr ? cache.Miss
+                                                   : reinterpret_cast<Byte*>(result) -
+                                                         reinterpret_cast<Byte*>(ptr));
+            return result;
+        }
+    }
+}  // namespace RTTI
+
+/**
+ * Dynamically cast the passed object to the passed type using an inline cache private
+ * to the call site.
+ * @param T Type to cast the object into.
+ * @param ptr Pointer to the object, may be a nullptr.
+ */
+#define RTTI_CAST_CACHED(T, ptr)                                                        \
+    RTTI::CachedCast<T>((ptr), []() -> auto& {                                          \
+        static RTTI::CastCache<std::remove_const_t<T>,                                  \
+                               std::remove_const_t<std::remove_pointer_t<              \
+                                   std::decay_t<decltype(ptr)>>>>                       \
+            cache;                                                                      \
+        return cache;                                                                   \
+    }())
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "id_slot.hh"
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /// Deduces the result and parameter types of a two parameter handler.
+        template <typename F>
+        struct BinaryHandlerTraits : BinaryHandlerTraits<decltype(&F::operator())> {};
+
+        template <typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (*)(A, B)> {
+            using Result = R;
+            using First = std::remove_cv_t<std::remove_reference_t<A>>;
+            using Second = std::remove_cv_t<std::remove_reference_t<B>>;
+        };
+
+        template <typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (*)(A, B) noexcept> : BinaryHandlerTraits<R (*)(A, B)> {};
+
+        template <typename C, typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (C::*)(A, B)> : BinaryHandlerTraits<R (*)(A, B)> {};
+
+        template <typename C, typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (C::*)(A, B) const> : BinaryHandlerTraits<R (*)(A, B)> {};
+
+        template <typename C, typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (C::*)(A, B) noexcept>
+            : BinaryHandlerTraits<R (*)(A, B)> {};
+
+        template <typename C, typename R, typename A, typename B>
+        struct BinaryHandlerTraits<R (C::*)(A, B) const noexcept>
+            : BinaryHandlerTraits<R (*)(A, B)> {};
+
+        template <typename F>
+        using BinaryTraits = BinaryHandlerTraits<std::decay_t<F>>;
+
+        /// Checks whether Ancestor is part of the declared ancestors of the type T.
+        template <typename Ancestor, typename T>
+        constexpr bool IsAncestor = Contains<Ancestor, typename T::TypeInfo::Ancestors>::value;
+
+        /// Number of declared ancestors of the type T, a measure of how derived T is.
+        template <typename T>
+        constexpr std::size_t AncestorCount = T::TypeInfo::AncestorTable::Size;
+
+        /**
+         * Compile-time generated two dimensional dispatch table for pairs of objects of
+         * the static types U and V, handled by the handlers of the types Fs. Each object
+         * is classified as the most derived of the types handled in either position,
+         * after which the handler of the pair of classes is a single table lookup. Objects
+         * that are an instance of several unrelated classes are resolved over all of them.
+         */
+        template <typename U, typename V, typename Classes, typename... Fs>
+        struct DoubleDispatcher;
+
+        template <typename U, typename V, typename... Cs, typename... Fs>
+        struct DoubleDispatcher<U, V, TypeList<Cs...>, Fs...> {
+            using Result = std::common_type_t<typename BinaryTraits<Fs>::Result...>;
+            using Handlers = std::tuple<Fs&...>;
+            using Thunk = Result (*)(U*, V*, Handlers&);
+
+            /// Number of classes, the class index Size denotes an unhandled object.
+            static constexpr std::size_t Size = sizeof...(Cs);
+            static constexpr std::size_t Stride = Size + 1;
+
+            template <std::size_t H>
+            using Handler = BinaryTraits<std::tuple_element_t<H, std::tuple<Fs...>>>;
+
+            /// Identifiers of the classes, sorted in ascending order.
+            using Sorted = SortedIds<TypeInfo<Cs>::Id()...>;
+
+            /// Identifiers of the classes, in the order of declaration.
+            static constexpr std::array<TypeId, Size> Ids = {TypeInfo<Cs>::Id()...};
+
+            /// Set of classes an object is an instance of, indexed by the class index.
+            using Matches = std::array<bool, Size>;
+
+            /// Returns the index of the class with the passed identifier.
+            [[nodiscard]] static constexpr std::size_t ClassIndex(TypeId typeId) noexcept {
+                std::size_t index = 0;
+                while (index < Size && Ids[index] != typeId) {
+                    ++index;
+                }
+                return index;
+            }
+
+            template <typename C>
+            static constexpr Matches AncestorsOf() noexcept {
+                return {IsAncestor<Cs, C>...};
+            }
+
+            /// Classes an instance of each class is an instance of, itself included.
+            static constexpr std::array<Matches, Size> Below = {AncestorsOf<Cs>()...};
+
+            /// Classification of objects that are an instance of several unrelated classes.
+            static constexpr std::size_t Ambiguous = Size + 1;
+
+            /// Ambiguous classifications are memoized with their matches if these fit.
+            static constexpr bool MemoizeMatches = Size < 31;
+            static constexpr std::uint32_t MatchesFlag = UINT32_C(1) << 31;
+
+            /// Number of entries in the direct mapped classification cache.
+            static constexpr std::size_t CacheSize = 64;
+
+            /**
+             * Classification of recently seen dynamic types, stored as the class index plus
+             * one. Ambiguous classifications are stored as the matched classes in the lower
+             * bits, flagged by the highest bit.
+             */
+            static inline std::array<IdSlot<>, CacheSize> cache{};
+
+            /// Checks the object against every class.
+            template <typename W>
+            [[nodiscard]] static Matches Match(W* ptr) noexcept {
+                constexpr std::array<bool (*)(W const*), Size> checks = {&RTTI::is<Cs, W>...};
+                Matches matches{};
+                for (std::size_t c = 0; c < Size; ++c) {
+                    matches[c] = checks[c](ptr);
+                }
+                return matches;
+            }
+
+            /**
+             * Classifies the object as the most derived class it is an instance of.
+             * Dynamic types which are not a class themselves are resolved by checking all
+             * classes, the result is memoized per dynamic type. In case the object is an
+             * instance of several classes none of which derives from all others, the
+             * classification is ambiguous and the classes are returned in matches.
+             * @returns Index of the class, Size if the object is not an instance of any,
+             * Ambiguous otherwise.
+             */
+            template <typename W>
+            [[nodiscard]] static std::size_t Classify(W* ptr, Matches& matches) noexcept {
+                auto const typeId = ptr->typeId();
+                if (auto const index = Sorted::Find(typeId); index != Size) {
+                    return index;
+                }
+
+                auto& entry = cache[typeId % CacheSize];
+                std::uint32_t cached;
+                if (entry.load(typeId, cached)) {
+                    if ((cached & MatchesFlag) == 0) {
+                        return static_cast<std::size_t>(cached) - 1;
+                    }
+                    for (std::size_t c = 0; c < Size; ++c) {
+                        matches[c] = (cached >> c) & 1;
+                    }
+                    return Ambiguous;
+                }
+
+                matches = Match(ptr);
+                auto const index = MostDerived(matches);
+                if (index != Ambiguous) {
+                    entry.store(typeId, static_cast<std::uint32_t>(index + 1));
+                } else if constexpr (MemoizeMatches) {
+                    std::uint32_t bits = MatchesFlag;
+                    for (std::size_t c = 0; c < Size; ++c) {
+                        bits |= static_cast<std::uint32_t>(matches[c]) << c;
+                    }
+                    entry.store(typeId, bits);
+                }
+                return index;
+            }
+
+            /**
+             * Finds the matched class all other matched classes are an ancestor of.
+             * @returns Index of the class, Size if none matched, Ambiguous if there is no
+             * such class.
+             */
+            [[nodiscard]] static constexpr std::size_t MostDerived(
+                Matches const& matches) noexcept {
+                std::size_t index = Size;
+                for (std::size_t c = 0; c < Size; ++c) {
+                    if (matches[c] && (index == Size || Below[c][index])) {
+                        index = c;
+                    }
+                }
+                for (std::size_t c = 0; index != Size && c < Size; ++c) {
+                    if (matches[c] && !Below[index][c]) {
+                        return Ambiguous;
+                    }
+                }
+                return index;
+            }
+
+            /// Invokes the handler H, with the objects swapped for symmetric handlers.
+            template <std::size_t H, bool Swapped>
+            static Result Invoke(U* a, V* b, Handlers& handlers) {
+                using First = typename Handler<H>::First;
+                using Second = typename Handler<H>::Second;
+                if constexpr (Swapped) {
+                    return std::get<H>(handlers)(*RTTI::cast<First>(b), *RTTI::cast<Second>(a));
+                } else {
+                    return std::get<H>(handlers)(*RTTI::cast<First>(a), *RTTI::cast<Second>(b));
+                }
+            }
+
+            static Result Unhandled(U*, V*, Handlers&) {
+                return Result();
+            }
+
+            /// Handler selected for a pair of classes.
+            struct Selection {
+                std::size_t handler;
+                bool swapped;
+            };
+
+            /**
+             * Selects the most specific handler for a pair of objects that are instances of
+             * the passed classes. Handlers apply if their parameters are among the classes,
+             * either in order or swapped. The handler whose parameters are the most derived
+             * wins, handlers applying in order are preferred over swapped ones.
+             */
+            static constexpr Selection Select(Matches const& a, Matches const& b) noexcept {
+                constexpr std::size_t n = sizeof...(Fs);
+                constexpr std::array<std::size_t, n> firsts = {
+                    ClassIndex(TypeInfo<typename BinaryTraits<Fs>::First>::Id())...};
+                constexpr std::array<std::size_t, n> seconds = {
+                    ClassIndex(TypeInfo<typename BinaryTraits<Fs>::Second>::Id())...};
+                constexpr std::array<std::size_t, n> scores = {
+                    (AncestorCount<typename BinaryTraits<Fs>::First> +
+                     AncestorCount<typename BinaryTraits<Fs>::Second>)...};
+
+                Selection selection = {n, false};
+                std::size_t best = 0;
+                for (std::size_t h = 0; h < n; ++h) {
+                    if (a[firsts[h]] && b[seconds[h]] &&
+                        (selection.handler == n || scores[h] > best ||
+                         (scores[h] == best && selection.swapped))) {
+                        selection = {h, false};
+                        best = scores[h];
+                    }
+                }
+                for (std::size_t h = 0; h < n; ++h) {
+                    if (a[seconds[h]] && b[firsts[h]] &&
+                        (selection.handler == n || scores[h] > best)) {
+                        selection = {h, true};
+                        best = scores[h];
+                    }
+                }
+                return selection;
+            }
+
+            /// Selects the most specific handler for the pair of classes I and J.
+            template <std::size_t I, std::size_t J>
+            static constexpr Selection Select() noexcept {
+                return Select(Below[I], Below[J]);
+            }
+
+            template <std::size_t K>
+            static constexpr Thunk MakeThunk() noexcept {
+                constexpr std::size_t i = K / Stride;
+                constexpr std::size_t j = K % Stride;
+                if constexpr (i == Size || j == Size) {
+                    return &Unhandled;
+                } else {
+                    constexpr auto selection = Select<i, j>();
+                    if constexpr (selection.handler == sizeof...(Fs)) {
+                        return &Unhandled;
+                    } else {
+                        return &Invoke<selection.handler, selection.swapped>;
+                    }
+                }
+            }
+
+            template <std::size_t... Ks>
+            static constexpr std::array<Thunk, Stride * Stride> MakeTable(
+                std::index_sequence<Ks...>) noexcept {
+                return {MakeThunk<Ks>()...};
+            }
+
+            /// Thunks indexed by the class of the first times Stride plus the second object.
+            static constexpr std::array<Thunk, Stride * Stride> Table =
+                MakeTable(std::make_index_sequence<Stride * Stride>{});
+
+            template <std::size_t... Hs>
+            static constexpr std::array<Thunk, 2 * sizeof...(Fs)> MakeInvokers(
+                std::index_sequence<Hs...>) noexcept {
+                return {&Invoke<Hs / 2, Hs % 2 == 1>...};
+            }
+
+            /// Thunks indexed by the handler times two plus whether the objects are swapped.
+            static constexpr std::array<Thunk, 2 * sizeof...(Fs)> Invokers =
+                MakeInvokers(std::make_index_sequence<2 * sizeof...(Fs)>{});
+
+            /// Returns the classes an object of the passed classification is an instance of.
+            [[nodiscard]] static Matches MatchesOf(std::size_t index, Matches const& matches) {
+                if (index < Size) {
+                    return Below[index];
+                }
+                return index == Ambiguous ? matches : Matches{};
+            }
+
+            static Result Dispatch(U* a, V* b, Handlers& handlers) {
+                Matches matchesA{};
+                Matches matchesB{};
+                auto const i = Classify(a, matchesA);
+                auto const j = Classify(b, matchesB);
+                if (i != Ambiguous && j != Ambiguous) {
+                    return Table[i * Stride + j](a, b, handlers);
+                }
+
+                auto const selection = Select(MatchesOf(i, matchesA), MatchesOf(j, matchesB));
+                if (selection.handler == sizeof...(Fs)) {
+                    return Result();
+                }
+                return Invokers[selection.handler * 2 + selection.swapped](a, b, handlers);
+            }
+        };
+    }  // namespace Detail
+
+    /**
+     * Invokes the handler matching the dynamic types of the passed pair of objects.
+     * Handlers are callables taking two references to types in the hierarchies of the
+     * objects. The handler table is generated at compile-time from the declared ancestors
+     * of the handled types. Each object is classified as the most derived handled type it
+     * is an instance of, after which the most specific handler for the pair is found
+     * using a single table lookup. Handlers are symmetric: a handler for (A, B) is also
+     * invoked for a pair (B, A), with the objects swapped, in case no handler for (B, A)
+     * is more specific. Objects of types that are an instance of multiple unrelated
+     * handled types are matched against the handlers of all of them, resolved per pair of
+     * objects.
+     *
+     * @param a The first object.
+     * @param b The second object.
+     * @param handlers The handlers to choose from.
+     * @returns The result of the invoked handler, a value initialized result in case no
+     * handler matched.
+     */
+    template <typename U, typename V, typename... Fs>
+    decltype(auto) dispatch2(U& a, V& b, Fs&&... handlers) {
+        static_assert(sizeof...(Fs) > 0, "At least one handler is required.");
+
+        using Firsts = Detail::TypeList<typename Detail::BinaryTraits<Fs>::First...>;
+        using Seconds = Detail::TypeList<typename Detail::BinaryTraits<Fs>::Second...>;
+        using Classes = typename Detail::Merge<Detail::TypeList<>, Firsts, Seconds>::type;
+
+        std::tuple<Fs&...> refs(handlers...);
+        return Detail::DoubleDispatcher<U, V, Classes, Fs...>::Dispatch(&a, &b, refs);
+    }
+}  // namespace RTTI
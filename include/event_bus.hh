@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtti.hh"
+#include "type_memo.hh"
+
+namespace RTTI {
+    /// Identifier of a subscription to an event bus, zero is never used.
+    using SubscriptionId = std::uint64_t;
+
+    /**
+     * Publish-subscribe bus for events of RTTI enabled types. Subscribers register for an
+     * event type and receive events of that type and of all types derived from it. The
+     * handlers subscribed to each dynamic event type, together with the adjustment from
+     * the event to the subscribed type, are computed once per dynamic type and stored
+     * contiguously. Publishing an event hence costs a single lookup of its type
+     * identifier followed by a run over the handlers.
+     *
+     * The subscriptions are held in an immutable snapshot that is replaced as a whole by
+     * subscribe and unsubscribe, read-copy-update style. The handlers of the dynamic event
+     * types are memoized in a lock-free table owned by the snapshot, and are carried over
+     * into the next snapshot, such that only the changed subscriptions are matched again.
+     * Publishers never take a lock nor write to memory shared with other publishers,
+     * except for a reader counter striped over cache lines and the first time a dynamic
+     * type is published. Replaced snapshots are reclaimed once all publishers that may
+     * still read them have finished.
+     */
+    class EventBus {
+        /// Handler of a subscription for a single dynamic event type.
+        struct Handler {
+            void (*invoke)(void const* callable, void* event);
+            void const* callable;
+            std::ptrdiff_t offset;
+        };
+
+        struct Subscription {
+            SubscriptionId id;
+            std::shared_ptr<void const> callable;
+            void (*invoke)(void const* callable, void* event);
+            void* (*cast)(Enable* event) noexcept;
+        };
+
+        /**
+         * Handlers of the subscriptions matching a dynamic event type, computed from the
+         * first covered subscriptions of a snapshot.
+         */
+        struct TypeHandlers {
+            TypeId id;
+            std::size_t covered;
+            std::vector<Handler> handlers;
+        };
+
+        /// Handlers kept alive by a snapshot, in a list grown by publishers.
+        struct Owned {
+            std::shared_ptr<TypeHandlers const> handlers;
+            Owned const* next;
+        };
+
+        /// Immutable subscriptions of the bus and the handlers of the dynamic event types.
+        struct Snapshot {
+            explicit Snapshot(std::size_t capacity)
+                : types(capacity)
+                , inherited(capacity) {}
+
+            Snapshot(Snapshot const&) = delete;
+            Snapshot& operator=(Snapshot const&) = delete;
+
+            ~Snapshot() {
+                for (auto const* node = owned.load(); node != nullptr;) {
+                    delete std::exchange(node, node->next);
+                }
+            }
+
+            /// Keeps the passed handlers alive as long as the snapshot.
+            void own(std::shared_ptr<TypeHandlers const> handlers) const {
+                auto* node = new Owned{std::move(handlers), owned.load(std::memory_order_relaxed)};
+                while (!owned.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                }
+            }
+
+            std::vector<Subscription> subscriptions;
+
+            /// Handlers of the dynamic event types covering all subscriptions.
+            mutable Detail::TypeMemo types;
+
+            /// Handlers carried over from the replaced snapshot, filled in before publishing.
+            Detail::TypeMemo inherited;
+
+            mutable std::atomic<Owned const*> owned{nullptr};
+            Snapshot* next = nullptr;
+        };
+
+        static constexpr std::size_t InitialCapacity = 16;
+
+        /// Number of reader counters, readers are spread over them by thread.
+        static constexpr std::size_t ReaderSlots = 32;
+
+        struct alignas(64) ReaderSlot {
+            std::array<std::atomic<std::uint64_t>, 2> counters{};
+        };
+
+        /// Marks the read side critical section of a publisher.
+        class ReadGuard {
+        public:
+            explicit ReadGuard(EventBus const& bus) noexcept
+                : _counter(bus._readers[ThreadSlot()]
+                               .counters[bus._epoch.load(std::memory_order_seq_cst) & 1]) {
+                _counter.fetch_add(1, std::memory_order_seq_cst);
+                ++ReadDepth();
+            }
+
+            ~ReadGuard() {
+                --ReadDepth();
+                _counter.fetch_sub(1, std::memory_order_release);
+            }
+
+            ReadGuard(ReadGuard const&) = delete;
+            ReadGuard& operator=(ReadGuard const&) = delete;
+
+        private:
+            std::atomic<std::uint64_t>& _counter;
+        };
+
+    public:
+        EventBus() : _current(new Snapshot(InitialCapacity)) {}
+
+        EventBus(EventBus const&) = delete;
+        EventBus& operator=(EventBus const&) = delete;
+
+        ~EventBus() {
+            Free(_retired.exchange(nullptr));
+            delete _current.load();
+        }
+
+        /**
+         * Subscribes the passed handler to events of the type T and all types derived
+         * from it. The handler is invoked with a reference to the event as T.
+         * @tparam T The event type, which has to declare its type information.
+         * @param handler Callable taking a T&.
+         * @returns The identifier of the subscription.
+         */
+        template <typename T, typename F>
+        SubscriptionId subscribe(F&& handler) {
+            using Callable = std::decay_t<F>;
+            static_assert(std::is_invocable_v<Callable const&, T&>,
+                          "The handler has to be invocable with a reference to the event.");
+
+            Subscription subscription;
+            subscription.callable = std::make_shared<Callable const>(std::forward<F>(handler));
+            subscription.invoke = [](void const* callable, void* event) {
+                (*static_cast<Callable const*>(callable))(*static_cast<T*>(event));
+            };
+            subscription.cast = [](Enable* event) noexcept -> void* {
+                return RTTI::cast<T>(event);
+            };
+            Snapshot* replaced;
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                subscription.id = ++_lastId;
+                replaced = update([&subscription](std::vector<Subscription>& subscriptions) {
+                    subscriptions.push_back(subscription);
+                    return true;
+                });
+            }
+            retire(replaced);
+            return subscription.id;
+        }
+
+        /**
+         * Removes the subscription with the passed identifier. Once unsubscribe returns
+         * the handler is no longer invoked, unless unsubscribe is called from within a
+         * handler in which case handlers running concurrently may still finish.
+         * @param id The identifier of the subscription.
+         * @returns False in case no such subscription exists.
+         */
+        bool unsubscribe(SubscriptionId id) {
+            Snapshot* replaced;
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                replaced = update([id](std::vector<Subscription>& subscriptions) {
+                    for (auto it = subscriptions.begin(); it != subscriptions.end(); ++it) {
+                        if (it->id == id) {
+                            subscriptions.erase(it);
+                            return true;
+                        }
+                    }
+                    return false;
+                });
+            }
+            if (replaced == nullptr) {
+                return false;
+            }
+            retire(replaced);
+            return true;
+        }
+
+        /**
+         * Invokes the handlers of all subscriptions to the type of the event or any of its
+         * ancestors, in order of subscription. Never waits for other publishers or
+         * subscribers.
+         * @param event The event to publish.
+         * @returns The number of handlers invoked.
+         */
+        template <typename E>
+        std::size_t publish(E& event) {
+            Enable& base = event;
+            auto* object = reinterpret_cast<char*>(&base);
+            auto const typeId = base.typeId();
+
+            std::size_t count;
+            {
+                ReadGuard guard(*this);
+                auto const* snapshot = _current.load(std::memory_order_seq_cst);
+                auto const found = snapshot->types.find(typeId);
+                auto const* handlers = reinterpret_cast<TypeHandlers const*>(found.value);
+                if (handlers == nullptr) {
+                    handlers = install(*snapshot, found, base);
+                }
+                for (auto const& handler : handlers->handlers) {
+                    handler.invoke(handler.callable, object + handler.offset);
+                }
+                count = handlers->handlers.size();
+            }
+            reclaim();
+            return count;
+        }
+
+        /// Returns the number of subscriptions.
+        [[nodiscard]] std::size_t size() const noexcept {
+            ReadGuard guard(*this);
+            return _current.load(std::memory_order_seq_cst)->subscriptions.size();
+        }
+
+    private:
+        static std::size_t ThreadSlot() noexcept {
+            static std::atomic<std::size_t> next{0};
+            thread_local std::size_t const slot =
+                next.fetch_add(1, std::memory_order_relaxed) % ReaderSlots;
+            return slot;
+        }
+
+        /// Number of read side critical sections the calling thread is in, on any bus.
+        static unsigned& ReadDepth() noexcept {
+            thread_local unsigned depth = 0;
+            return depth;
+        }
+
+        static void Free(Snapshot* snapshot) noexcept {
+            while (snapshot != nullptr) {
+                delete std::exchange(snapshot, snapshot->next);
+            }
+        }
+
+        /**
+         * Computes the handlers for the dynamic type of the passed event and memoizes them
+         * in the snapshot. Handlers carried over from the replaced snapshot are extended by
+         * the subscriptions they do not cover yet.
+         * @returns The handlers of the dynamic type of the event.
+         */
+        static TypeHandlers const* install(Snapshot const& snapshot,
+                                           Detail::TypeMemo::Found const& found,
+                                           Enable& event) {
+            auto const typeId = event.typeId();
+            auto const& subscriptions = snapshot.subscriptions;
+            auto const* handlers = reinterpret_cast<TypeHandlers const*>(
+                snapshot.inherited.find(typeId).value);
+
+            if (handlers == nullptr || handlers->covered != subscriptions.size()) {
+                auto built = std::make_shared<TypeHandlers>();
+                built->id = typeId;
+                built->covered = subscriptions.size();
+                std::size_t first = 0;
+                if (handlers != nullptr) {
+                    built->handlers = handlers->handlers;
+                    first = handlers->covered;
+                }
+                auto* object = reinterpret_cast<char*>(&event);
+                for (auto i = first; i < subscriptions.size(); ++i) {
+                    auto const& subscription = subscriptions[i];
+                    if (auto* target = static_cast<char*>(subscription.cast(&event))) {
+                        built->handlers.push_back(Handler{
+                            subscription.invoke, subscription.callable.get(), target - object});
+                    }
+                }
+                handlers = built.get();
+                snapshot.own(std::move(built));
+            }
+            snapshot.types.insert(found, typeId, reinterpret_cast<std::uintptr_t>(handlers));
+            return handlers;
+        }
+
+        /**
+         * Carries the handlers memoized by the passed snapshot over into a snapshot holding
+         * the passed subscriptions, which have been appended to or removed from those of the
+         * passed snapshot. Handlers of removed subscriptions are dropped.
+         * @returns The snapshot, not published yet.
+         */
+        static Snapshot* inherit(Snapshot const& from, std::vector<Subscription> subscriptions) {
+            std::vector<std::shared_ptr<TypeHandlers const>> carried;
+            for (auto const* node = from.owned.load(std::memory_order_acquire); node != nullptr;
+                 node = node->next) {
+                carried.push_back(node->handlers);
+            }
+            // Of the handlers of the same type, those covering the most subscriptions win
+            std::sort(carried.begin(), carried.end(), [](auto const& a, auto const& b) {
+                return a->id != b->id ? a->id < b->id : a->covered > b->covered;
+            });
+            carried.erase(std::unique(carried.begin(), carried.end(),
+                                      [](auto const& a, auto const& b) { return a->id == b->id; }),
+                          carried.end());
+
+            // Subscriptions are ordered by identifier, the removed ones are missing
+            std::vector<bool> removed(from.subscriptions.size());
+            bool anyRemoved = false;
+            for (std::size_t i = 0, j = 0; i < from.subscriptions.size(); ++i) {
+                if (j < subscriptions.size() && subscriptions[j].id == from.subscriptions[i].id) {
+                    ++j;
+                } else {
+                    removed[i] = anyRemoved = true;
+                }
+            }
+
+            auto capacity = InitialCapacity;
+            while (capacity < carried.size() * 2) {
+                capacity *= 2;
+            }
+            auto* next = new Snapshot(capacity);
+            next->subscriptions = std::move(subscriptions);
+            for (auto& handlers : carried) {
+                if (anyRemoved) {
+                    handlers = Filter(*handlers, from.subscriptions, removed);
+                }
+                auto const id = handlers->id;
+                next->inherited.insert(next->inherited.find(id), id,
+                                       reinterpret_cast<std::uintptr_t>(handlers.get()));
+                next->own(std::move(handlers));
+            }
+            return next;
+        }
+
+        /// Drops the handlers of the removed subscriptions from the passed handlers.
+        static std::shared_ptr<TypeHandlers const> Filter(TypeHandlers const& handlers,
+                                                          std::vector<Subscription> const& from,
+                                                          std::vector<bool> const& removed) {
+            auto filtered = std::make_shared<TypeHandlers>();
+            filtered->id = handlers.id;
+            filtered->covered = handlers.covered;
+            std::vector<void const*> callables;
+            for (std::size_t i = 0; i < handlers.covered; ++i) {
+                if (removed[i]) {
+                    --filtered->covered;
+                    callables.push_back(from[i].callable.get());
+                }
+            }
+            for (auto const& handler : handlers.handlers) {
+                if (std::find(callables.begin(), callables.end(), handler.callable) ==
+                    callables.end()) {
+                    filtered->handlers.push_back(handler);
+                }
+            }
+            return filtered;
+        }
+
+        /**
+         * Replaces the snapshot by one with the subscriptions modified by the passed
+         * function, carrying the handlers of the dynamic event types over. Called with the
+         * writer lock held, the replaced snapshot is retired after releasing it.
+         * @returns The replaced snapshot, nullptr in case nothing was modified.
+         */
+        template <typename F>
+        Snapshot* update(F&& modify) {
+            auto* current = _current.load(std::memory_order_seq_cst);
+            auto subscriptions = current->subscriptions;
+            if (!modify(subscriptions)) {
+                return nullptr;
+            }
+            _current.store(inherit(*current, std::move(subscriptions)), std::memory_order_seq_cst);
+            return current;
+        }
+
+        /**
+         * Reclaims the passed snapshot and the snapshots retired from within handlers, once
+         * the publishers that may read them have finished. Must not be called with the
+         * writer lock held, as a handler waiting for the lock would never finish. From
+         * within a handler the snapshot is deferred to the first publisher leaving its
+         * handlers instead, which would otherwise wait for itself.
+         */
+        void retire(Snapshot* snapshot) noexcept {
+            if (ReadDepth() > 0) {
+                snapshot->next = _retired.load(std::memory_order_relaxed);
+                while (!_retired.compare_exchange_weak(snapshot->next, snapshot,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed)) {
+                }
+                return;
+            }
+            snapshot->next = _retired.exchange(nullptr, std::memory_order_acquire);
+            synchronize();
+            Free(snapshot);
+        }
+
+        /// Frees the snapshots retired from within handlers, unless called from within one.
+        void reclaim() noexcept {
+            if (_retired.load(std::memory_order_relaxed) == nullptr || ReadDepth() > 0) {
+                return;
+            }
+            if (auto* retired = _retired.exchange(nullptr, std::memory_order_acquire)) {
+                synchronize();
+                Free(retired);
+            }
+        }
+
+        /// Waits until all publishers that started before the call have finished.
+        void synchronize() noexcept {
+            auto const epoch = _epoch.load(std::memory_order_relaxed);
+            drain((epoch + 1) & 1);
+            _epoch.fetch_add(1, std::memory_order_seq_cst);
+            drain(epoch & 1);
+        }
+
+        void drain(std::size_t index) noexcept {
+            for (auto& reader : _readers) {
+                while (reader.counters[index].load(std::memory_order_seq_cst) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        std::atomic<Snapshot*> _current;
+        std::atomic<Snapshot*> _retired{nullptr};
+        std::atomic<std::uint32_t> _epoch{0};
+        mutable std::array<ReaderSlot, ReaderSlots> _readers{};
+        std::mutex _writer;
+        SubscriptionId _lastId = 0;
+    };
+}  // namespace RTTI
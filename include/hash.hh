@@ -4,16 +4,82 @@
 #include <cstdint>
 
 namespace Hash {
-    /** 
+    namespace Detail {
+        static constexpr std::uint32_t Rotl32(std::uint32_t x, unsigned r) {
+            return (x << r) | (x >> (32 - r));
+        }
+
+        static constexpr std::uint64_t Rotl64(std::uint64_t x, unsigned r) {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        /// Reads a little endian 32bit word, independent of the byte order of the host.
+        static constexpr std::uint32_t Read32(const char* p) {
+            return static_cast<std::uint32_t>(static_cast<unsigned char>(p[0])) |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(p[1])) << 8 |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(p[2])) << 16 |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(p[3])) << 24;
+        }
+
+        /// Reads a little endian 64bit word, independent of the byte order of the host.
+        static constexpr std::uint64_t Read64(const char* p) {
+            return static_cast<std::uint64_t>(Read32(p)) |
+                   static_cast<std::uint64_t>(Read32(p + 4)) << 32;
+        }
+
+        static constexpr std::uint32_t P32[5] = {
+            UINT32_C(0x9E3779B1), UINT32_C(0x85EBCA77), UINT32_C(0xC2B2AE3D),
+            UINT32_C(0x27D4EB2F), UINT32_C(0x165667B1)};
+
+        static constexpr std::uint64_t P64[5] = {
+            UINT64_C(0x9E3779B185EBCA87), UINT64_C(0xC2B2AE3D27D4EB4F),
+            UINT64_C(0x165667B19E3779F9), UINT64_C(0x85EBCA77C2B2AE63),
+            UINT64_C(0x27D4EB2F165667C5)};
+
+        static constexpr std::uint32_t XXH32Round(std::uint32_t acc, std::uint32_t input) {
+            return Rotl32(acc + input * P32[1], 13) * P32[0];
+        }
+
+        static constexpr std::uint64_t XXH64Round(std::uint64_t acc, std::uint64_t input) {
+            return Rotl64(acc + input * P64[1], 31) * P64[0];
+        }
+
+        static constexpr std::uint64_t XXH64Merge(std::uint64_t acc, std::uint64_t v) {
+            return (acc ^ XXH64Round(0, v)) * P64[0] + P64[3];
+        }
+
+        /// Mixes the trailing bytes of the input into the accumulator and finalizes it.
+        static constexpr std::uint32_t XXH32Finalize(const char* p, std::size_t n, std::uint32_t h) {
+            for (; n >= 4; p += 4, n -= 4) {
+                h = Rotl32(h + Read32(p) * P32[2], 17) * P32[3];
+            }
+            for (; n > 0; ++p, --n) {
+                h = Rotl32(h + static_cast<unsigned char>(*p) * P32[4], 11) * P32[0];
+            }
+            h ^= h >> 15;
+            h *= P32[1];
+            h ^= h >> 13;
+            h *= P32[2];
+            h ^= h >> 16;
+            return h;
+        }
+    }
+
+    /**
      * Calculates the 32bit FNV1a hash of a c-string literal.
+     * The hash is calculated iteratively such that long strings, e.g. the names of deeply
+     * nested template types, do not run into the constexpr recursion limit of the compiler.
      * @param str String literal to be hashed
      * @param n Length of the string.
      * @return Calculated hash of the string
      */
     static constexpr std::uint32_t FNV1a(const char* str, std::size_t n, std::uint32_t hash = UINT32_C(2166136261)) {
-        return n == 0 ? hash : FNV1a(str + 1, n - 1, (hash ^ str[0]) * UINT32_C(19777619));
+        for (std::size_t i = 0; i < n; ++i) {
+            hash = (hash ^ static_cast<std::uint32_t>(str[i])) * UINT32_C(19777619);
+        }
+        return hash;
     }
-    
+
     /**
      * Calculates the 32bit FNV1a hash of a std::string_view literal.
      * note: Requires string_view to be a literal in order to be evaluated during compile time!
@@ -23,4 +89,96 @@ namespace Hash {
     static constexpr std::uint32_t FNV1a(std::string_view str) {
         return FNV1a(str.data(), str.size());
     }
+
+    /**
+     * Calculates the 64bit FNV1a hash of a string.
+     * @param str String to be hashed
+     * @return Calculated hash of the string
+     */
+    static constexpr std::uint64_t FNV1a64(std::string_view str) {
+        std::uint64_t hash = UINT64_C(14695981039346656037);
+        for (auto const c : str) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * UINT64_C(1099511628211);
+        }
+        return hash;
+    }
+
+    /**
+     * Calculates the 32bit xxHash (XXH32) of a string. Mixes considerably better than
+     * FNV1a, at runtime the four independent accumulators hash long strings several times
+     * faster as well.
+     * @param str String to be hashed
+     * @param seed Seed of the hash
+     * @return Calculated hash of the string
+     */
+    static constexpr std::uint32_t XXH32(std::string_view str, std::uint32_t seed = 0) {
+        auto p = str.data();
+        auto n = str.size();
+        std::uint32_t h = seed + Detail::P32[4];
+        if (n >= 16) {
+            std::uint32_t v1 = seed + Detail::P32[0] + Detail::P32[1];
+            std::uint32_t v2 = seed + Detail::P32[1];
+            std::uint32_t v3 = seed;
+            std::uint32_t v4 = seed - Detail::P32[0];
+            for (; n >= 16; p += 16, n -= 16) {
+                v1 = Detail::XXH32Round(v1, Detail::Read32(p));
+                v2 = Detail::XXH32Round(v2, Detail::Read32(p + 4));
+                v3 = Detail::XXH32Round(v3, Detail::Read32(p + 8));
+                v4 = Detail::XXH32Round(v4, Detail::Read32(p + 12));
+            }
+            h = Detail::Rotl32(v1, 1) + Detail::Rotl32(v2, 7) + Detail::Rotl32(v3, 12) +
+                Detail::Rotl32(v4, 18);
+        }
+        h += static_cast<std::uint32_t>(str.size());
+        return Detail::XXH32Finalize(p, n, h);
+    }
+
+    /**
+     * Calculates the 64bit xxHash (XXH64) of a string.
+     * @param str String to be hashed
+     * @param seed Seed of the hash
+     * @return Calculated hash of the string
+     */
+    static constexpr std::uint64_t XXH64(std::string_view str, std::uint64_t seed = 0) {
+        using Detail::P64;
+        auto p = str.data();
+        auto n = str.size();
+        std::uint64_t h = seed + P64[4];
+        if (n >= 32) {
+            std::uint64_t v1 = seed + P64[0] + P64[1];
+            std::uint64_t v2 = seed + P64[1];
+            std::uint64_t v3 = seed;
+            std::uint64_t v4 = seed - P64[0];
+            for (; n >= 32; p += 32, n -= 32) {
+                v1 = Detail::XXH64Round(v1, Detail::Read64(p));
+                v2 = Detail::XXH64Round(v2, Detail::Read64(p + 8));
+                v3 = Detail::XXH64Round(v3, Detail::Read64(p + 16));
+                v4 = Detail::XXH64Round(v4, Detail::Read64(p + 24));
+            }
+            h = Detail::Rotl64(v1, 1) + Detail::Rotl64(v2, 7) + Detail::Rotl64(v3, 12) +
+                Detail::Rotl64(v4, 18);
+            h = Detail::XXH64Merge(h, v1);
+            h = Detail::XXH64Merge(h, v2);
+            h = Detail::XXH64Merge(h, v3);
+            h = Detail::XXH64Merge(h, v4);
+        }
+        h += static_cast<std::uint64_t>(str.size());
+        for (; n >= 8; p += 8, n -= 8) {
+            h = Detail::Rotl64(h ^ Detail::XXH64Round(0, Detail::Read64(p)), 27) * P64[0] + P64[3];
+        }
+        if (n >= 4) {
+            h = Detail::Rotl64(h ^ (Detail::Read32(p) * P64[0]), 23) * P64[1] + P64[2];
+            p += 4;
+            n -= 4;
+        }
+        for (; n > 0; ++p, --n) {
+            h = Detail::Rotl64(h ^ (static_cast<unsigned char>(*p) * P64[4]), 11) * P64[0];
+        }
+        h ^= h >> 33;
+        h *= P64[1];
+        h ^= h >> 29;
+        h *= P64[2];
+        h ^= h >> 32;
+        return h;
+    }
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /**
+         * Atomic cache entry mapping a type identifier onto a non-zero 32-bit value, used by
+         * the lock-free caches keyed by dynamic type. Concurrent lookups and updates never
+         * observe a torn entry. With 32-bit type identifiers the identifier and the value
+         * are packed into a single atomic word, wider identifiers are guarded by a sequence
+         * counter instead. An update racing with another update is dropped.
+         */
+        template <typename Id = TypeId>
+        struct IdSlot {
+            /**
+             * Looks up the value stored for the passed type identifier.
+             * @param id The type identifier.
+             * @param value Set to the stored value in case found.
+             * @returns True in case the entry holds the passed type identifier.
+             */
+            [[nodiscard]] bool load(Id id, std::uint32_t& value) const noexcept {
+                auto const s = seq.load(std::memory_order_acquire);
+                if (s & 1) {
+                    return false;
+                }
+                auto const storedId = this->id.load(std::memory_order_relaxed);
+                auto const storedValue = this->value.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) != s || storedValue == 0 ||
+                    storedId != id) {
+                    return false;
+                }
+                value = storedValue;
+                return true;
+            }
+
+            /**
+             * Stores the value for the passed type identifier, replacing the entry.
+             * @param id The type identifier.
+             * @param value The non-zero value.
+             */
+            void store(Id id, std::uint32_t value) noexcept {
+                auto s = seq.load(std::memory_order_relaxed);
+                if ((s & 1) ||
+                    !seq.compare_exchange_strong(s, s + 1, std::memory_order_relaxed)) {
+                    return;
+                }
+                std::atomic_thread_fence(std::memory_order_release);
+                this->id.store(id, std::memory_order_relaxed);
+                this->value.store(value, std::memory_order_relaxed);
+                seq.store(s + 2, std::memory_order_release);
+            }
+
+            std::atomic<std::uint32_t> seq{0};
+            std::atomic<std::uint32_t> value{0};
+            std::atomic<Id> id{0};
+        };
+
+        template <>
+        struct IdSlot<std::uint32_t> {
+            [[nodiscard]] bool load(std::uint32_t id, std::uint32_t& value) const noexcept {
+                auto const word = this->word.load(std::memory_order_relaxed);
+                if (static_cast<std::uint32_t>(word) == 0 ||
+                    static_cast<std::uint32_t>(word >> 32) != id) {
+                    return false;
+                }
+                value = static_cast<std::uint32_t>(word);
+                return true;
+            }
+
+            void store(std::uint32_t id, std::uint32_t value) noexcept {
+                word.store((static_cast<std::uint64_t>(id) << 32) | value,
+                           std::memory_order_relaxed);
+            }
+
+            std::atomic<std::uint64_t> word{0};
+        };
+    }  // namespace Detail
+}  // namespace RTTI
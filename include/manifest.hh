@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    /**
+     * Header of a binary type manifest. A manifest is a single position independent
+     * buffer holding the header, the type entries sorted by identifier, the sorted
+     * ancestor identifiers of each type and the null terminated type names. All fields
+     * are stored in the byte order of the writing host and all offsets are relative to the
+     * start of the buffer, such that a manifest can be mapped into memory and queried in
+     * place without any parsing.
+     */
+    struct ManifestHeader {
+        static constexpr char Magic[8] = {'R', 'T', 'T', 'I', 'M', 'A', 'N', '\0'};
+        static constexpr std::uint32_t Version = 1;
+        static constexpr std::uint32_t ByteOrder = 0x01020304;
+
+        /// Flags describing how the type identifiers were derived.
+        static constexpr std::uint32_t XXHash = 1u << 0;
+        static constexpr std::uint32_t RawTypeNames = 1u << 1;
+
+        /// Flags of the type identifiers of this build.
+        static constexpr std::uint32_t Flags =
+#ifdef RTTI_USE_XXHASH
+            XXHash |
+#endif
+#ifdef RTTI_RAW_TYPE_NAMES
+            RawTypeNames |
+#endif
+            0;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t idBits;
+        std::uint32_t flags;
+        std::uint64_t size;
+        std::uint64_t count;
+        std::uint64_t entries;
+        std::uint64_t ancestors;
+        std::uint64_t names;
+    };
+
+    /// Type entry of a binary type manifest.
+    struct ManifestEntry {
+        std::uint64_t id;
+
+        /// Offset of the null terminated name relative to the names of the manifest.
+        std::uint32_t name;
+        std::uint32_t nameLength;
+
+        /// Index of the first ancestor identifier, the ancestors include the type itself.
+        std::uint32_t ancestors;
+        std::uint32_t ancestorCount;
+    };
+
+    /**
+     * Read-only view on a binary type manifest, e.g. mapped into memory from a file
+     * written by another process. The manifest is validated once on construction, after
+     * which queries are binary searches on the mapped data. The view only accepts
+     * manifests whose type identifiers were derived the same way as those of the build
+     * of the view.
+     */
+    class ManifestView {
+    public:
+        /// Contiguous range of type identifiers.
+        struct Ids {
+            std::uint64_t const* first;
+            std::uint64_t const* last;
+
+            [[nodiscard]] std::uint64_t const* begin() const noexcept {
+                return first;
+            }
+
+            [[nodiscard]] std::uint64_t const* end() const noexcept {
+                return last;
+            }
+
+            [[nodiscard]] std::size_t size() const noexcept {
+                return static_cast<std::size_t>(last - first);
+            }
+        };
+
+        ManifestView() noexcept = default;
+
+        /**
+         * Constructs a view on the passed manifest.
+         * @param data Pointer to the manifest, aligned to eight bytes.
+         * @param size Size of the manifest in bytes.
+         */
+        ManifestView(void const* data, std::size_t size) noexcept {
+            auto const* bytes = static_cast<unsigned char const*>(data);
+            if (bytes == nullptr || size < sizeof(ManifestHeader) ||
+                reinterpret_cast<std::uintptr_t>(bytes) % alignof(std::uint64_t) != 0) {
+                return;
+            }
+
+            auto const* header = reinterpret_cast<ManifestHeader const*>(bytes);
+            if (std::memcmp(header->magic, ManifestHeader::Magic, sizeof(header->magic)) != 0 ||
+                header->version != ManifestHeader::Version ||
+                header->byteOrder != ManifestHeader::ByteOrder ||
+                header->idBits != RTTI_TYPEID_BITS || header->flags != ManifestHeader::Flags ||
+                header->size > size || header->entries % alignof(ManifestEntry) != 0 ||
+                header->ancestors % alignof(std::uint64_t) != 0 ||
+                header->entries > header->ancestors || header->ancestors > header->names ||
+                header->names > header->size ||
+                (header->ancestors - header->entries) / sizeof(ManifestEntry) < header->count) {
+                return;
+            }
+
+            auto const* entries = reinterpret_cast<ManifestEntry const*>(bytes + header->entries);
+            auto const ancestorCount =
+                (header->names - header->ancestors) / sizeof(std::uint64_t);
+            auto const namesSize = header->size - header->names;
+            for (std::size_t i = 0; i < header->count; ++i) {
+                auto const& entry = entries[i];
+                if ((i > 0 && entries[i - 1].id >= entry.id) ||
+                    std::uint64_t{entry.ancestors} + entry.ancestorCount > ancestorCount ||
+                    std::uint64_t{entry.name} + entry.nameLength >= namesSize) {
+                    return;
+                }
+            }
+
+            _header = header;
+            _entries = entries;
+            _ancestors = reinterpret_cast<std::uint64_t const*>(bytes + header->ancestors);
+            _names = reinterpret_cast<char const*>(bytes + header->names);
+        }
+
+        /// Checks whether the manifest passed validation.
+        [[nodiscard]] bool valid() const noexcept {
+            return _header != nullptr;
+        }
+
+        explicit operator bool() const noexcept {
+            return valid();
+        }
+
+        /// Returns the number of types in the manifest.
+        [[nodiscard]] std::size_t size() const noexcept {
+            return valid() ? static_cast<std::size_t>(_header->count) : 0;
+        }
+
+        [[nodiscard]] ManifestEntry const* begin() const noexcept {
+            return _entries;
+        }
+
+        [[nodiscard]] ManifestEntry const* end() const noexcept {
+            return _entries + size();
+        }
+
+        /**
+         * Finds the entry of the type identified by the passed type id.
+         * @param typeId The identifier of the type.
+         * @returns The entry of the type, nullptr if not found.
+         */
+        [[nodiscard]] ManifestEntry const* find(TypeId typeId) const noexcept {
+            auto const it = std::lower_bound(
+                begin(), end(), std::uint64_t{typeId},
+                [](ManifestEntry const& entry, std::uint64_t id) { return entry.id < id; });
+            return it != end() && it->id == typeId ? it : nullptr;
+        }
+
+        /// Returns the name of the type of the passed entry.
+        [[nodiscard]] std::string_view name(ManifestEntry const& entry) const noexcept {
+            return std::string_view(_names + entry.name, entry.nameLength);
+        }
+
+        /// Returns the sorted identifiers of the ancestors of the type of the passed entry.
+        [[nodiscard]] Ids ancestors(ManifestEntry const& entry) const noexcept {
+            auto const* first = _ancestors + entry.ancestors;
+            return Ids{first, first + entry.ancestorCount};
+        }
+
+        /**
+         * Checks whether the type identified by typeId is, or derives from, the type
+         * identified by ancestorId.
+         * @returns True in case the type is found and is an instance of the ancestor.
+         */
+        [[nodiscard]] bool is(TypeId typeId, TypeId ancestorId) const noexcept {
+            auto const* entry = find(typeId);
+            if (entry == nullptr) {
+                return false;
+            }
+            auto const ids = ancestors(*entry);
+            return std::binary_search(ids.begin(), ids.end(), std::uint64_t{ancestorId});
+        }
+
+        /**
+         * Checks whether the manifest describes the passed type the same way as this
+         * process does, i.e. whether it holds the type with the same set of ancestors.
+         * @param descriptor The descriptor of the type.
+         * @returns True in case the type matches.
+         */
+        [[nodiscard]] bool matches(Detail::TypeDescriptor const& descriptor) const noexcept {
+            auto const* entry = find(descriptor.id);
+            if (entry == nullptr || entry->ancestorCount != descriptor.size) {
+                return false;
+            }
+            auto const ids = ancestors(*entry);
+            for (std::size_t i = 0; i < descriptor.size; ++i) {
+                if (!std::binary_search(ids.begin(), ids.end(),
+                                        std::uint64_t{descriptor.ids[i]})) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        ManifestHeader const* _header = nullptr;
+        ManifestEntry const* _entries = nullptr;
+        std::uint64_t const* _ancestors = nullptr;
+        char const* _names = nullptr;
+    };
+
+    /**
+     * Binary type manifest owning its storage, as produced by ManifestBuilder. The
+     * storage is aligned such that it can be queried in place or written to a file.
+     */
+    class Manifest {
+    public:
+        explicit Manifest(std::vector<std::uint64_t> words) noexcept : _words(std::move(words)) {}
+
+        [[nodiscard]] void const* data() const noexcept {
+            return _words.data();
+        }
+
+        /// Returns the size of the manifest in bytes.
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _words.empty()
+                       ? 0
+                       : static_cast<std::size_t>(
+                             reinterpret_cast<ManifestHeader const*>(_words.data())->size);
+        }
+
+        [[nodiscard]] ManifestView view() const noexcept {
+            return ManifestView(data(), size());
+        }
+
+    private:
+        std::vector<std::uint64_t> _words;
+    };
+
+    /**
+     * Collects the identifiers, names and ancestors of a set of types into a binary type
+     * manifest.
+     */
+    class ManifestBuilder {
+    public:
+        /**
+         * Adds the type described by the passed descriptor, adding the same type more
+         * than once has no effect.
+         * @param descriptor The descriptor of the type.
+         * @returns False in case another type with the same identifier was added already.
+         */
+        bool add(Detail::TypeDescriptor const& descriptor) {
+            auto const it = std::lower_bound(
+                _types.begin(), _types.end(), descriptor.id,
+                [](Detail::TypeDescriptor const* type, TypeId id) { return type->id < id; });
+            if (it != _types.end() && (*it)->id == descriptor.id) {
+                return (*it)->name == descriptor.name;
+            }
+            _types.insert(it, &descriptor);
+            return true;
+        }
+
+        /**
+         * Adds the types Ts, which have to declare their type information.
+         * @returns False in case any of the types collides with a type added before.
+         */
+        template <typename... Ts>
+        bool add() {
+            return (add(Ts::TypeInfo::Descriptor()) & ...);
+        }
+
+        /// Returns the number of types added.
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _types.size();
+        }
+
+        /// Builds the manifest of the types added.
+        [[nodiscard]] Manifest build() const {
+            std::size_t ancestorCount = 0;
+            std::size_t namesSize = 0;
+            for (auto const* type : _types) {
+                ancestorCount += type->size;
+                namesSize += type->name.size() + 1;
+            }
+
+            ManifestHeader header{};
+            std::memcpy(header.magic, ManifestHeader::Magic, sizeof(header.magic));
+            header.version = ManifestHeader::Version;
+            header.byteOrder = ManifestHeader::ByteOrder;
+            header.idBits = RTTI_TYPEID_BITS;
+            header.flags = ManifestHeader::Flags;
+            header.count = _types.size();
+            header.entries = sizeof(ManifestHeader);
+            header.ancestors = header.entries + _types.size() * sizeof(ManifestEntry);
+            header.names = header.ancestors + ancestorCount * sizeof(std::uint64_t);
+            header.size = header.names + namesSize;
+
+            constexpr auto wordSize = sizeof(std::uint64_t);
+            std::vector<std::uint64_t> words((header.size + wordSize - 1) / wordSize);
+            auto* bytes = reinterpret_cast<unsigned char*>(words.data());
+            std::memcpy(bytes, &header, sizeof(header));
+
+            auto* entries = reinterpret_cast<ManifestEntry*>(bytes + header.entries);
+            auto* ancestors = reinterpret_cast<std::uint64_t*>(bytes + header.ancestors);
+            auto* names = reinterpret_cast<char*>(bytes + header.names);
+            std::uint32_t ancestor = 0;
+            std::uint32_t name = 0;
+            for (auto const* type : _types) {
+                auto& entry = *entries++;
+                entry.id = type->id;
+                entry.name = name;
+                entry.nameLength = static_cast<std::uint32_t>(type->name.size());
+                entry.ancestors = ancestor;
+                entry.ancestorCount = static_cast<std::uint32_t>(type->size);
+
+                std::copy(type->ids, type->ids + type->size, ancestors + ancestor);
+                std::sort(ancestors + ancestor, ancestors + ancestor + type->size);
+                ancestor += entry.ancestorCount;
+
+                std::memcpy(names + name, type->name.data(), type->name.size());
+                name += entry.nameLength + 1;
+            }
+            return Manifest(std::move(words));
+        }
+
+    private:
+        std::vector<Detail::TypeDescriptor const*> _types;
+    };
+}  // namespace RTTI
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /// Type pointed to by the result of casting a pointer to U into T.
+        template <typename T, typename U>
+        using CastElement = std::remove_pointer_t<CastResult<T, U>>;
+
+        /**
+         * Casts the passed object without checking its type in case static_cast is able to,
+         * looking the type up otherwise, which is the case for downcasts through a virtual
+         * base.
+         */
+        template <typename T, typename U>
+        [[nodiscard]] CastResult<T, U> StaticCast(U* ptr) noexcept {
+            if constexpr (IsStaticCastable<U, CastElement<T, U>>::value) {
+                return static_cast<CastResult<T, U>>(ptr);
+            } else {
+                return RTTI::cast<T>(ptr);
+            }
+        }
+
+        /// Deleter of a unique_ptr cast into T, default deleters are replaced by that of T.
+        template <typename T, typename D>
+        struct CastDeleter {
+            using type = D;
+        };
+
+        template <typename T, typename U>
+        struct CastDeleter<T, std::default_delete<U>> {
+            using type = std::default_delete<T>;
+        };
+    }  // namespace Detail
+
+    /**
+     * Base of types whose objects are owned by RTTI::Ref handles. The reference count is
+     * held by the object itself instead of a separate control block, and moving a handle
+     * into a handle of another type leaves the count untouched. Types mixing in the base
+     * through several parents have to derive from it virtually.
+     */
+    class RefCounted : public virtual Enable {
+        RTTI_DECLARE_TYPEINFO(RefCounted);
+
+    public:
+        /// Returns the number of handles referencing the object.
+        [[nodiscard]] std::size_t refCount() const noexcept {
+            return _refs.load(std::memory_order_relaxed);
+        }
+
+    protected:
+        RefCounted() noexcept = default;
+
+        /// Copies of an object are not referenced by the handles of the original.
+        RefCounted(RefCounted const&) noexcept {}
+
+        RefCounted& operator=(RefCounted const&) noexcept {
+            return *this;
+        }
+
+    private:
+        template <typename>
+        friend class Ref;
+
+        void retain() const noexcept {
+            _refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() const noexcept {
+            if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete this;
+            }
+        }
+
+        mutable std::atomic<std::size_t> _refs{0};
+    };
+
+    /**
+     * Intrusive shared handle to an object of a type derived from RTTI::RefCounted.
+     * @tparam T The type of the referenced object.
+     */
+    template <typename T>
+    class Ref {
+        static_assert(std::is_base_of_v<RefCounted, T>,
+                      "Referenced types have to derive from RTTI::RefCounted.");
+
+        template <typename U>
+        using EnableIfConvertible = std::enable_if_t<std::is_convertible_v<U*, T*>>;
+
+    public:
+        using element_type = T;
+
+        Ref() noexcept = default;
+
+        Ref(std::nullptr_t) noexcept {}
+
+        /// Constructs a handle referencing the passed object, which may be a nullptr.
+        explicit Ref(T* ptr) noexcept
+            : _ptr(ptr) {
+            if (_ptr != nullptr) {
+                Counted(_ptr)->retain();
+            }
+        }
+
+        Ref(Ref const& other) noexcept
+            : Ref(other._ptr) {}
+
+        template <typename U, typename = EnableIfConvertible<U>>
+        Ref(Ref<U> const& other) noexcept
+            : Ref(other.get()) {}
+
+        Ref(Ref&& other) noexcept
+            : _ptr(other.detach()) {}
+
+        template <typename U, typename = EnableIfConvertible<U>>
+        Ref(Ref<U>&& other) noexcept
+            : _ptr(other.detach()) {}
+
+        ~Ref() {
+            reset();
+        }
+
+        Ref& operator=(Ref other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        /**
+         * Takes over the reference of a handle released using detach, without
+         * incrementing the reference count.
+         */
+        [[nodiscard]] static Ref Adopt(T* ptr) noexcept {
+            Ref ref;
+            ref._ptr = ptr;
+            return ref;
+        }
+
+        /**
+         * Releases the reference without decrementing the reference count, such that it
+         * can be adopted by another handle.
+         * @returns Pointer to the object, nullptr if the handle is empty.
+         */
+        T* detach() noexcept {
+            return std::exchange(_ptr, nullptr);
+        }
+
+        void reset() noexcept {
+            if (_ptr != nullptr) {
+                Counted(detach())->release();
+            }
+        }
+
+        void swap(Ref& other) noexcept {
+            std::swap(_ptr, other._ptr);
+        }
+
+        [[nodiscard]] T* get() const noexcept {
+            return _ptr;
+        }
+
+        [[nodiscard]] T& operator*() const noexcept {
+            return *_ptr;
+        }
+
+        [[nodiscard]] T* operator->() const noexcept {
+            return _ptr;
+        }
+
+        explicit operator bool() const noexcept {
+            return _ptr != nullptr;
+        }
+
+    private:
+        static RefCounted const* Counted(T* ptr) noexcept {
+            return ptr;
+        }
+
+        T* _ptr = nullptr;
+    };
+
+    template <typename T, typename U>
+    [[nodiscard]] bool operator==(Ref<T> const& a, Ref<U> const& b) noexcept {
+        return a.get() == b.get();
+    }
+
+    template <typename T, typename U>
+    [[nodiscard]] bool operator!=(Ref<T> const& a, Ref<U> const& b) noexcept {
+        return a.get() != b.get();
+    }
+
+    template <typename T>
+    [[nodiscard]] bool operator==(Ref<T> const& ref, std::nullptr_t) noexcept {
+        return !ref;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool operator!=(Ref<T> const& ref, std::nullptr_t) noexcept {
+        return static_cast<bool>(ref);
+    }
+
+    /**
+     * Constructs an object of the type T referenced by a handle.
+     * @param args Arguments passed to the constructor of T.
+     * @returns Handle referencing the object.
+     */
+    template <typename T, typename... Args>
+    [[nodiscard]] Ref<T> make_ref(Args&&... args) {
+        return Ref<T>(new T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * Casts the object owned by the passed shared pointer into the type T, sharing the
+     * ownership using the aliasing constructor.
+     * @returns Shared pointer to the object as a T, nullptr in case it is not a T.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] std::shared_ptr<Detail::CastElement<T, U>> dynamic_pointer_cast(
+        std::shared_ptr<U> const& ptr) noexcept {
+        if (auto* const result = RTTI::cast<T>(ptr.get())) {
+            return std::shared_ptr<Detail::CastElement<T, U>>(ptr, result);
+        }
+        return nullptr;
+    }
+
+#if __cplusplus > 201703L
+    /**
+     * Casts the object owned by the passed shared pointer into the type T, moving the
+     * ownership in case the cast succeeds. The pointer is left untouched otherwise.
+     * Before C++20 the aliasing constructor can only copy, so rvalues are copied by the
+     * overload above rather than copied and reset, which touches the count twice.
+     * @returns Shared pointer to the object as a T, nullptr in case it is not a T.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] std::shared_ptr<Detail::CastElement<T, U>> dynamic_pointer_cast(
+        std::shared_ptr<U>&& ptr) noexcept {
+        if (auto* const result = RTTI::cast<T>(ptr.get())) {
+            return std::shared_ptr<Detail::CastElement<T, U>>(std::move(ptr), result);
+        }
+        return nullptr;
+    }
+#endif
+
+    /**
+     * Casts the object owned by the passed shared pointer into the type T without
+     * checking whether the object is a T.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] std::shared_ptr<Detail::CastElement<T, U>> static_pointer_cast(
+        std::shared_ptr<U> const& ptr) noexcept {
+        return std::shared_ptr<Detail::CastElement<T, U>>(ptr, Detail::StaticCast<T>(ptr.get()));
+    }
+
+#if __cplusplus > 201703L
+    template <typename T, typename U>
+    [[nodiscard]] std::shared_ptr<Detail::CastElement<T, U>> static_pointer_cast(
+        std::shared_ptr<U>&& ptr) noexcept {
+        auto* const result = Detail::StaticCast<T>(ptr.get());
+        return std::shared_ptr<Detail::CastElement<T, U>>(std::move(ptr), result);
+    }
+#endif
+
+    /**
+     * Casts the object owned by the passed unique pointer into the type T, transferring
+     * the ownership only in case the cast succeeds. The pointer is left untouched
+     * otherwise. Default deleters are replaced by the default deleter of T, which relies
+     * on the virtual destructor of RTTI::Enable. Other deleters are copied in case the
+     * cast fails and they are not default constructible.
+     * @returns Unique pointer to the object as a T, nullptr in case it is not a T.
+     */
+    template <typename T, typename U, typename D>
+    [[nodiscard]] std::unique_ptr<Detail::CastElement<T, U>,
+                                  typename Detail::CastDeleter<Detail::CastElement<T, U>, D>::type>
+    dynamic_pointer_cast(std::unique_ptr<U, D>&& ptr) noexcept {
+        using Result =
+            std::unique_ptr<Detail::CastElement<T, U>,
+                            typename Detail::CastDeleter<Detail::CastElement<T, U>, D>::type>;
+        auto* const result = RTTI::cast<T>(ptr.get());
+        if (result == nullptr) {
+            if constexpr (std::is_default_constructible_v<typename Result::deleter_type>) {
+                return Result();
+            } else {
+                return Result(nullptr, ptr.get_deleter());
+            }
+        }
+        if constexpr (std::is_same_v<typename Result::deleter_type, D>) {
+            Result cast(result, std::move(ptr.get_deleter()));
+            ptr.release();
+            return cast;
+        } else {
+            ptr.release();
+            return Result(result);
+        }
+    }
+
+    /// Casts the object referenced by the passed handle into the type T.
+    template <typename T, typename U>
+    [[nodiscard]] Ref<Detail::CastElement<T, U>> dynamic_pointer_cast(Ref<U> const& ptr) noexcept {
+        return Ref<Detail::CastElement<T, U>>(RTTI::cast<T>(ptr.get()));
+    }
+
+    /**
+     * Casts the object referenced by the passed handle into the type T, moving the
+     * reference in case the cast succeeds without touching the reference count. The
+     * handle is left untouched otherwise.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] Ref<Detail::CastElement<T, U>> dynamic_pointer_cast(Ref<U>&& ptr) noexcept {
+        auto* const result = RTTI::cast<T>(ptr.get());
+        if (result == nullptr) {
+            return nullptr;
+        }
+        ptr.detach();
+        return Ref<Detail::CastElement<T, U>>::Adopt(result);
+    }
+
+    /// Casts the object referenced by the passed handle into the type T without checking.
+    template <typename T, typename U>
+    [[nodiscard]] Ref<Detail::CastElement<T, U>> static_pointer_cast(Ref<U> const& ptr) noexcept {
+        return Ref<Detail::CastElement<T, U>>(Detail::StaticCast<T>(ptr.get()));
+    }
+
+    template <typename T, typename U>
+    [[nodiscard]] Ref<Detail::CastElement<T, U>> static_pointer_cast(Ref<U>&& ptr) noexcept {
+        auto* const result = Detail::StaticCast<T>(ptr.get());
+        ptr.detach();
+        return Ref<Detail::CastElement<T, U>>::Adopt(result);
+    }
+}  // namespace RTTI
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    /// Stable reference to an object stored in a PolyVector.
+    struct PolyHandle {
+        std::uint32_t index;
+        std::uint32_t generation;
+
+        [[nodiscard]] constexpr bool operator==(PolyHandle const& other) const noexcept {
+            return index == other.index && generation == other.generation;
+        }
+
+        [[nodiscard]] constexpr bool operator!=(PolyHandle const& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+
+    namespace Detail {
+        /**
+         * Type erased contiguous storage of the objects of a single most specialized type.
+         * Only the operations that depend on the stored type are virtual, iteration is
+         * performed by the container using the stride of the type and the adjustment into
+         * the iterated type, which is the same for all objects in the arena.
+         */
+        template <typename Base>
+        struct PolyArena {
+            explicit PolyArena(TypeDescriptor const& descriptor) noexcept
+                : descriptor(descriptor) {}
+
+            virtual ~PolyArena() = default;
+
+            /// Returns a pointer to the first object, as the most specialized type.
+            [[nodiscard]] virtual void* data() noexcept = 0;
+
+            /// Returns the object at the passed slot as the base type.
+            [[nodiscard]] virtual Base* at(std::size_t slot) noexcept = 0;
+
+            /// Moves the last object into the passed slot and removes the last slot.
+            virtual void swapPop(std::size_t slot) = 0;
+
+            /**
+             * Removes the objects of the flagged slots, preserving the order of the others.
+             * @param remove Flags of the slots to be removed.
+             * @returns Number of removed objects.
+             */
+            virtual std::size_t compact(std::vector<bool> const& remove) = 0;
+
+            virtual void clear() noexcept = 0;
+            virtual void shrinkToFit() = 0;
+
+            /**
+             * Returns the adjustment from an object in the arena into the type identified
+             * by the passed type id.
+             * @returns The adjustment in bytes, the arena may not be empty.
+             */
+            [[nodiscard]] std::ptrdiff_t offsetOf(TypeId typeId) noexcept {
+                auto* const object = data();
+                return static_cast<char const*>(descriptor.cast(typeId, object)) -
+                       static_cast<char const*>(object);
+            }
+
+            TypeDescriptor const& descriptor;
+            std::size_t stride = 0;
+
+            /// Handle table index of the object in each slot.
+            std::vector<std::uint32_t> handles;
+        };
+
+        template <typename Base, typename T>
+        struct PolyArenaOf final : PolyArena<Base> {
+            PolyArenaOf() noexcept : PolyArena<Base>(T::TypeInfo::Descriptor()) {
+                this->stride = sizeof(T);
+            }
+
+            [[nodiscard]] void* data() noexcept override {
+                return objects.data();
+            }
+
+            [[nodiscard]] Base* at(std::size_t slot) noexcept override {
+                return &objects[slot];
+            }
+
+            void swapPop(std::size_t slot) override {
+                if (slot + 1 != objects.size()) {
+                    objects[slot] = std::move(objects.back());
+                    this->handles[slot] = this->handles.back();
+                }
+                objects.pop_back();
+                this->handles.pop_back();
+            }
+
+            std::size_t compact(std::vector<bool> const& remove) override {
+                std::size_t next = 0;
+                for (std::size_t slot = 0; slot < objects.size(); ++slot) {
+                    if (!remove[slot]) {
+                        if (next != slot) {
+                            objects[next] = std::move(objects[slot]);
+                            this->handles[next] = this->handles[slot];
+                        }
+                        ++next;
+                    }
+                }
+                auto const removed = objects.size() - next;
+                objects.erase(objects.begin() + next, objects.end());
+                this->handles.resize(next);
+                return removed;
+            }
+
+            void clear() noexcept override {
+                objects.clear();
+                this->handles.clear();
+            }
+
+            void shrinkToFit() override {
+                objects.shrink_to_fit();
+                this->handles.shrink_to_fit();
+            }
+
+            std::vector<T> objects;
+        };
+    }  // namespace Detail
+
+    /**
+     * Container of polymorphic objects derived from Base which stores the objects of each
+     * most specialized type contiguously in an arena of its own, rather than as separate
+     * heap allocations. Iterating the objects of a type T visits the arenas of the types
+     * derived from T only, as found in their ancestor tables, and adjusts each object into
+     * T using an offset computed once per arena. Objects are referenced by stable handles,
+     * pointers and references to objects are invalidated by insertions and removals.
+     * Stored types have to be move constructible and move assignable, and have to declare
+     * their own type information.
+     * @tparam Base The common base of the stored objects.
+     */
+    template <typename Base>
+    class PolyVector {
+        static_assert(std::is_base_of_v<Enable, Base>, "Base is not based on top of RTTI::Enable.");
+
+        using Arena = Detail::PolyArena<Base>;
+
+        /// Location of the object referenced by a handle, or the next free entry.
+        struct Entry {
+            std::uint32_t arena;
+            std::uint32_t slot;
+            std::uint32_t generation;
+        };
+
+        static constexpr std::uint32_t Free = ~std::uint32_t{0};
+
+    public:
+        using Handle = PolyHandle;
+
+        PolyVector() = default;
+        PolyVector(PolyVector&&) noexcept = default;
+        PolyVector& operator=(PolyVector&&) noexcept = default;
+
+        /**
+         * Constructs an object of type T at the end of the arena of T.
+         * @param args Arguments passed to the constructor of T.
+         * @returns Handle referencing the object.
+         */
+        template <typename T, typename... Args>
+        Handle emplace(Args&&... args) {
+            static_assert(std::is_base_of_v<Base, T>, "T is not derived from Base.");
+            static_assert(std::is_same_v<typename T::TypeInfo::T, T>,
+                          "T does not declare its own type information.");
+
+            auto const arenaIndex = arenaOf<T>();
+            auto& arena = static_cast<Detail::PolyArenaOf<Base, T>&>(*_arenas[arenaIndex]);
+
+            // The handle is reserved before the object is constructed, such that a throwing
+            // allocation or constructor leaves no object without a handle behind
+            if (_free == Free) {
+                _entries.push_back({Free, Free, 0});
+                _free = static_cast<std::uint32_t>(_entries.size() - 1);
+            }
+            auto const index = _free;
+            arena.handles.push_back(index);
+            try {
+                arena.objects.emplace_back(std::forward<Args>(args)...);
+            } catch (...) {
+                arena.handles.pop_back();
+                throw;
+            }
+
+            auto& entry = _entries[index];
+            _free = entry.slot;
+            entry.arena = arenaIndex;
+            entry.slot = static_cast<std::uint32_t>(arena.objects.size() - 1);
+            ++_size;
+            return {index, entry.generation};
+        }
+
+        /**
+         * Checks whether the passed handle references an object in the container.
+         * @returns False in case the object has been erased.
+         */
+        [[nodiscard]] bool contains(Handle handle) const noexcept {
+            return handle.index < _entries.size() &&
+                   _entries[handle.index].generation == handle.generation &&
+                   _entries[handle.index].arena != Free;
+        }
+
+        /**
+         * Returns the object referenced by the passed handle.
+         * @returns Pointer to the object, nullptr in case it has been erased.
+         */
+        [[nodiscard]] Base* get(Handle handle) noexcept {
+            if (!contains(handle)) {
+                return nullptr;
+            }
+            auto const& entry = _entries[handle.index];
+            return _arenas[entry.arena]->at(entry.slot);
+        }
+
+        [[nodiscard]] Base const* get(Handle handle) const noexcept {
+            return const_cast<PolyVector*>(this)->get(handle);
+        }
+
+        /**
+         * Returns the object referenced by the passed handle as the passed type.
+         * @returns Pointer to the object, nullptr in case it has been erased or is not an
+         * instance of T.
+         */
+        template <typename T>
+        [[nodiscard]] T* get(Handle handle) noexcept {
+            return RTTI::cast<T>(get(handle));
+        }
+
+        template <typename T>
+        [[nodiscard]] T const* get(Handle handle) const noexcept {
+            return RTTI::cast<T>(get(handle));
+        }
+
+        /**
+         * Erases the object referenced by the passed handle. The last object of the same
+         * arena takes its place, such that erasing is constant time.
+         * @returns False in case the object had already been erased.
+         */
+        bool erase(Handle handle) {
+            if (!contains(handle)) {
+                return false;
+            }
+            auto& entry = _entries[handle.index];
+            auto& arena = *_arenas[entry.arena];
+            auto const slot = entry.slot;
+            arena.swapPop(slot);
+            if (slot < arena.handles.size()) {
+                _entries[arena.handles[slot]].slot = slot;
+            }
+            release(handle.index);
+            --_size;
+            return true;
+        }
+
+        /**
+         * Erases all objects of the type T for which the passed predicate returns true. The
+         * arenas of the affected types are compacted once, preserving the order of the
+         * remaining objects.
+         * @tparam T The type of the objects to consider.
+         * @param predicate Callable invoked with a reference to each object as T.
+         * @returns Number of erased objects.
+         */
+        template <typename T = Base, typename Predicate>
+        std::size_t erase_if(Predicate&& predicate) {
+            std::size_t erased = 0;
+            std::vector<bool> remove;
+            for (std::uint32_t a = 0; a < _arenas.size(); ++a) {
+                auto& arena = *_arenas[a];
+                auto const count = arena.handles.size();
+                if (count == 0 || !holds<T>(arena)) {
+                    continue;
+                }
+
+                remove.assign(count, false);
+                bool any = false;
+                auto* object =
+                    static_cast<char*>(arena.data()) + arena.offsetOf(TypeInfo<T>::Id());
+                for (std::size_t slot = 0; slot < count; ++slot, object += arena.stride) {
+                    if (predicate(*reinterpret_cast<T*>(object))) {
+                        remove[slot] = true;
+                        any = true;
+                    }
+                }
+                if (!any) {
+                    continue;
+                }
+
+                for (std::size_t slot = 0; slot < count; ++slot) {
+                    if (remove[slot]) {
+                        release(arena.handles[slot]);
+                    }
+                }
+                auto const removed = arena.compact(remove);
+                for (std::size_t slot = 0; slot < arena.handles.size(); ++slot) {
+                    _entries[arena.handles[slot]].slot = static_cast<std::uint32_t>(slot);
+                }
+                erased += removed;
+            }
+            _size -= erased;
+            return erased;
+        }
+
+        /**
+         * Invokes the passed callable for each object that is an instance of the type T.
+         * Only the arenas of the types derived from T are visited, each object is adjusted
+         * into T by the offset of its arena rather than a cast.
+         * @tparam T The type of the objects to visit.
+         * @param callable Callable invoked with a reference to each object as T.
+         */
+        template <typename T = Base, typename F>
+        void for_each(F&& callable) {
+            forEachArena<T>(*this, callable);
+        }
+
+        template <typename T = Base, typename F>
+        void for_each(F&& callable) const {
+            forEachArena<T const>(*this, callable);
+        }
+
+        /**
+         * Returns the number of objects that are an instance of the type T.
+         */
+        template <typename T = Base>
+        [[nodiscard]] std::size_t count() const noexcept {
+            std::size_t total = 0;
+            for (auto const& arena : _arenas) {
+                if (holds<T>(*arena)) {
+                    total += arena->handles.size();
+                }
+            }
+            return total;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        /// Erases all objects, invalidating all handles.
+        void clear() noexcept {
+            for (auto& arena : _arenas) {
+                for (auto const index : arena->handles) {
+                    release(index);
+                }
+                arena->clear();
+            }
+            _size = 0;
+        }
+
+        /// Releases unused capacity of the arenas.
+        void shrink_to_fit() {
+            for (auto& arena : _arenas) {
+                arena->shrinkToFit();
+            }
+        }
+
+    private:
+        /// Checks whether the objects of the passed arena are instances of the type T.
+        template <typename T>
+        [[nodiscard]] static bool holds(Arena const& arena) noexcept {
+            return arena.descriptor.find(TypeInfo<T>::Id()) != arena.descriptor.size;
+        }
+
+        /// Returns the index of the arena of the type T, creating it on first use.
+        template <typename T>
+        std::uint32_t arenaOf() {
+            constexpr auto typeId = TypeInfo<T>::Id();
+            auto const it = std::lower_bound(
+                _index.begin(), _index.end(), typeId,
+                [](std::pair<TypeId, std::uint32_t> const& entry, TypeId id) {
+                    return entry.first < id;
+                });
+            if (it != _index.end() && it->first == typeId) {
+                return it->second;
+            }
+            auto const index = static_cast<std::uint32_t>(_arenas.size());
+            _arenas.push_back(std::make_unique<Detail::PolyArenaOf<Base, T>>());
+            _index.insert(it, {typeId, index});
+            return index;
+        }
+
+        template <typename T, typename Self, typename F>
+        static void forEachArena(Self& self, F& callable) {
+            using Byte = std::conditional_t<std::is_const_v<T>, char const, char>;
+            constexpr auto typeId = TypeInfo<std::remove_const_t<T>>::Id();
+
+            for (auto const& arena : self._arenas) {
+                auto const count = arena->handles.size();
+                if (count == 0 || !holds<std::remove_const_t<T>>(*arena)) {
+                    continue;
+                }
+                auto* object = static_cast<Byte*>(arena->data()) + arena->offsetOf(typeId);
+                for (std::size_t slot = 0; slot < count; ++slot, object += arena->stride) {
+                    callable(*reinterpret_cast<T*>(object));
+                }
+            }
+        }
+
+        void release(std::uint32_t index) noexcept {
+            auto& entry = _entries[index];
+            entry.arena = Free;
+            entry.slot = _free;
+            ++entry.generation;
+            _free = index;
+        }
+
+        std::vector<std::unique_ptr<Arena>> _arenas;
+
+        /// Arena indices sorted by the type identifier of the stored type.
+        std::vector<std::pair<TypeId, std::uint32_t>> _index;
+
+        std::vector<Entry> _entries;
+        std::uint32_t _free = Free;
+        std::size_t _size = 0;
+    };
+}  // namespace RTTI
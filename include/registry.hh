@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtti.hh"
+
+/// Registry entries are collected from a dedicated linker section on ELF targets, other
+/// targets fall back to registration during static initialization.
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(RTTI_REGISTRY_USE_STATIC_INIT)
+    #define RTTI_DETAIL_REGISTRY_SECTION
+#endif
+
+namespace RTTI {
+    /**
+     * Constant description of a registered type, holding the functions to create and
+     * destroy objects of the type using its pool.
+     */
+    struct RegistryEntry {
+        TypeId id;
+        std::string_view name;
+        Detail::TypeDescriptor const* descriptor;
+
+        /// Default constructs an object, nullptr if not default constructible.
+        void* (*create)();
+
+        /// Destroys an object created by create and returns its memory to the pool.
+        void (*destroy)(void*) noexcept;
+
+        /// Converts an object created by create into its RTTI::Enable base.
+        Enable* (*enable)(void*) noexcept;
+
+#ifndef RTTI_DETAIL_REGISTRY_SECTION
+        RegistryEntry const* next;
+#endif
+    };
+
+    namespace Detail {
+        /**
+         * Fixed-size allocator handing out chunks of Size bytes from blocks which are never
+         * returned to the system. Each thread allocates from and releases into a free list
+         * of its own, which exchanges batches of chunks with a shared free list guarded by
+         * a spin lock. Allocating and releasing short-lived objects hence neither calls
+         * into malloc nor synchronizes with other threads in the common case. Once the free
+         * list of a thread has been destroyed on thread exit, such as when releasing objects
+         * from other thread local or static destructors, chunks go to the shared free list
+         * directly. Types of the same size and alignment share a pool.
+         */
+        template <std::size_t Size, std::size_t Align>
+        class FixedPool {
+            union Chunk {
+                Chunk* next;
+                alignas(Align) unsigned char storage[Size];
+            };
+
+            static constexpr std::size_t BlockChunks = 256;
+            static constexpr std::size_t BatchChunks = 64;
+
+        public:
+            FixedPool(FixedPool const&) = delete;
+            FixedPool& operator=(FixedPool const&) = delete;
+
+            /// Returns the pool, which is never destroyed such that pooled objects may
+            /// outlive static destruction.
+            [[nodiscard]] static FixedPool& Instance() {
+                static auto* const pool = new FixedPool();
+                return *pool;
+            }
+
+            [[nodiscard]] void* allocate() {
+                auto* const cache = LocalCache();
+                if (cache == nullptr) {
+                    Lock lock(_lock);
+                    grow();
+                    auto* const chunk = _free;
+                    _free = chunk->next;
+                    return chunk->storage;
+                }
+                if (cache->head == nullptr) {
+                    refill(*cache);
+                }
+                auto* const chunk = cache->head;
+                cache->head = chunk->next;
+                --cache->count;
+                return chunk->storage;
+            }
+
+            void deallocate(void* ptr) noexcept {
+                auto* const cache = LocalCache();
+                auto* const chunk = static_cast<Chunk*>(ptr);
+                if (cache == nullptr) {
+                    Lock lock(_lock);
+                    chunk->next = _free;
+                    _free = chunk;
+                    return;
+                }
+                chunk->next = cache->head;
+                cache->head = chunk;
+                if (++cache->count > 2 * BatchChunks) {
+                    drain(*cache, BatchChunks);
+                }
+            }
+
+        private:
+            enum class State : unsigned char { Unused, Active, Destroyed };
+
+            /**
+             * Free list of a single thread. Trivially destructible, such that its state can
+             * still be read after the destructors of the thread have run.
+             */
+            struct Cache {
+                Chunk* head;
+                std::size_t count;
+                State state;
+            };
+
+            /// Returns the free list of the calling thread to the shared list on thread exit.
+            struct Reaper {
+                Reaper() noexcept {
+                    _cache.state = State::Active;
+                }
+
+                ~Reaper() {
+                    auto& cache = _cache;
+                    cache.state = State::Destroyed;
+                    Instance().drain(cache, cache.count);
+                }
+
+                Reaper(Reaper const&) = delete;
+                Reaper& operator=(Reaper const&) = delete;
+            };
+
+            struct Lock {
+                explicit Lock(std::atomic_flag& flag) noexcept : flag(flag) {
+                    while (flag.test_and_set(std::memory_order_acquire)) {
+                    }
+                }
+
+                ~Lock() {
+                    flag.clear(std::memory_order_release);
+                }
+
+                std::atomic_flag& flag;
+            };
+
+            FixedPool() = default;
+
+            /// Returns the free list of the calling thread, nullptr once it has been destroyed.
+            static Cache* LocalCache() noexcept {
+                auto& cache = _cache;
+                if (cache.state != State::Active) {
+                    if (cache.state == State::Destroyed) {
+                        return nullptr;
+                    }
+                    thread_local Reaper const reaper;
+                    static_cast<void>(reaper);
+                }
+                return &cache;
+            }
+
+            /// Allocates a block of chunks in case the shared list is empty, locked by the caller.
+            void grow() {
+                if (_free == nullptr) {
+                    auto* const block = static_cast<Chunk*>(::operator new(
+                        sizeof(Chunk) * BlockChunks, std::align_val_t{alignof(Chunk)}));
+                    for (std::size_t i = 0; i < BlockChunks; ++i) {
+                        block[i].next = _free;
+                        _free = &block[i];
+                    }
+                }
+            }
+
+            void refill(Cache& cache) {
+                Lock lock(_lock);
+                grow();
+                for (std::size_t i = 0; i < BatchChunks && _free != nullptr; ++i) {
+                    auto* const chunk = _free;
+                    _free = chunk->next;
+                    chunk->next = cache.head;
+                    cache.head = chunk;
+                    ++cache.count;
+                }
+            }
+
+            void drain(Cache& cache, std::size_t count) noexcept {
+                Lock lock(_lock);
+                for (std::size_t i = 0; i < count && cache.head != nullptr; ++i) {
+                    auto* const chunk = cache.head;
+                    cache.head = chunk->next;
+                    --cache.count;
+                    chunk->next = _free;
+                    _free = chunk;
+                }
+            }
+
+            static inline thread_local Cache _cache{nullptr, 0, State::Unused};
+
+            std::atomic_flag _lock = ATOMIC_FLAG_INIT;
+            Chunk* _free = nullptr;
+        };
+
+        /// Returns the pool from which objects of the type T are allocated.
+        template <typename T>
+        FixedPool<sizeof(T), alignof(T)>& PoolOf() {
+            return FixedPool<sizeof(T), alignof(T)>::Instance();
+        }
+
+        template <typename T>
+        void*
+        CreatePooled() {
+            if constexpr (std::is_default_constructible_v<T>) {
+                auto& pool = PoolOf<T>();
+                auto* const memory = pool.allocate();
+                try {
+                    return new (memory) T();
+                } catch (...) {
+                    pool.deallocate(memory);
+                    throw;
+                }
+            } else {
+                return nullptr;
+            }
+        }
+
+        template <typename T>
+        void
+        DestroyPooled(void* ptr) noexcept {
+            auto* const object = static_cast<T*>(ptr);
+            object->~T();
+            PoolOf<T>().deallocate(object);
+        }
+
+        template <typename T>
+        Enable*
+        EnablePooled(void* ptr) noexcept {
+            return static_cast<T*>(ptr);
+        }
+
+        /// Returns the identifiers of the passed types.
+        template <typename... Ts>
+        constexpr std::array<TypeId, sizeof...(Ts)> IdsOf() noexcept {
+            return {TypeInfo<Ts>::Id()...};
+        }
+
+        template <typename T>
+        constexpr RegistryEntry MakeRegistryEntry() noexcept {
+            static_assert(std::is_same_v<typename T::TypeInfo::T, T>,
+                          "T does not declare its own type information.");
+            return {T::TypeInfo::Id(), T::TypeInfo::Name(), &T::TypeInfo::Descriptor(),
+                    &CreatePooled<T>, &DestroyPooled<T>, &EnablePooled<T>
+#ifndef RTTI_DETAIL_REGISTRY_SECTION
+                    , nullptr
+#endif
+            };
+        }
+
+#ifdef RTTI_DETAIL_REGISTRY_SECTION
+        /// Bounds of the section holding the registry entries, defined by the linker. Weak
+        /// such that both are null in case no type has been registered.
+        extern "C" [[gnu::weak]] RegistryEntry const __start_rtti_registry[];  // NOLINT
+        extern "C" [[gnu::weak]] RegistryEntry const __stop_rtti_registry[];   // NOLINT
+#else
+        /// Head of the list of entries registered during static initialization.
+        inline std::atomic<RegistryEntry const*> registryHead{nullptr};
+
+        struct RegistryLink {
+            explicit RegistryLink(RegistryEntry& entry) noexcept {
+                entry.next = registryHead.load(std::memory_order_relaxed);
+                while (!registryHead.compare_exchange_weak(entry.next, &entry)) {
+                }
+            }
+        };
+#endif
+    }  // namespace Detail
+
+    /**
+     * Registry of the types which opted in using RTTI_REGISTER. The entries are constant
+     * data collected by the linker, hence the registry requires no initialization at
+     * startup. Lookup tables sorted by identifier and name are built on first use, at which
+     * point distinct types sharing an identifier are reported and the program aborted,
+     * rather than resolving identifiers to the wrong type.
+     */
+    class Registry {
+    public:
+        /**
+         * Looks up the entry of the type identified by the passed type id.
+         * @returns The entry, nullptr in case the type is not registered.
+         */
+        [[nodiscard]] static RegistryEntry const* find(TypeId typeId) noexcept {
+            auto const& byId = tables().byId;
+            auto const it = std::lower_bound(
+                byId.begin(), byId.end(), typeId,
+                [](RegistryEntry const* entry, TypeId id) { return entry->id < id; });
+            return it != byId.end() && (*it)->id == typeId ? *it : nullptr;
+        }
+
+        /**
+         * Looks up the entry of the type with the passed name.
+         * @returns The entry, nullptr in case the type is not registered.
+         */
+        [[nodiscard]] static RegistryEntry const* find(std::string_view name) noexcept {
+            auto const& byName = tables().byName;
+            auto const it = std::lower_bound(
+                byName.begin(), byName.end(), name,
+                [](RegistryEntry const* entry, std::string_view n) { return entry->name < n; });
+            return it != byName.end() && (*it)->name == name ? *it : nullptr;
+        }
+
+        /// Returns the entries of all registered types, sorted by type identifier.
+        [[nodiscard]] static std::vector<RegistryEntry const*> const& entries() noexcept {
+            return tables().byId;
+        }
+
+    private:
+        struct Tables {
+            std::vector<RegistryEntry const*> byId;
+            std::vector<RegistryEntry const*> byName;
+        };
+
+        static Tables const& tables() noexcept {
+            static Tables const tables = build();
+            return tables;
+        }
+
+        static Tables build() noexcept {
+            Tables tables;
+#ifdef RTTI_DETAIL_REGISTRY_SECTION
+            for (auto const* entry = Detail::__start_rtti_registry;
+                 entry != Detail::__stop_rtti_registry; ++entry) {
+                tables.byId.push_back(entry);
+            }
+#else
+            for (auto const* entry = Detail::registryHead.load(); entry != nullptr;
+                 entry = entry->next) {
+                tables.byId.push_back(entry);
+            }
+#endif
+            std::sort(tables.byId.begin(), tables.byId.end(),
+                      [](RegistryEntry const* a, RegistryEntry const* b) {
+                          return a->id != b->id ? a->id < b->id : a->name < b->name;
+                      });
+
+            // Types registered from multiple translation units have identical entries.
+            tables.byId.erase(std::unique(tables.byId.begin(), tables.byId.end(),
+                                          [](RegistryEntry const* a, RegistryEntry const* b) {
+                                              return a->id == b->id && a->name == b->name;
+                                          }),
+                              tables.byId.end());
+
+            for (std::size_t i = 1; i < tables.byId.size(); ++i) {
+                auto const* a = tables.byId[i - 1];
+                auto const* b = tables.byId[i];
+                if (a->id == b->id) {
+                    std::fprintf(stderr, "RTTI: type identifier collision between %.*s and %.*s\n",
+                                 static_cast<int>(a->name.size()), a->name.data(),
+                                 static_cast<int>(b->name.size()), b->name.data());
+                    std::abort();
+                }
+            }
+
+            tables.byName = tables.byId;
+            std::sort(tables.byName.begin(), tables.byName.end(),
+                      [](RegistryEntry const* a, RegistryEntry const* b) {
+                          return a->name < b->name;
+                      });
+            return tables;
+        }
+    };
+
+    /**
+     * Deleter returning pooled objects to the pool of their type. Holds the object as its
+     * most specialized type, such that no cast is required to destroy it.
+     */
+    struct PoolDeleter {
+        void (*destroy)(void*) noexcept = nullptr;
+        void* object = nullptr;
+
+        template <typename T>
+        void operator()(T*) const noexcept {
+            destroy(object);
+        }
+    };
+
+    /// Owning pointer to an object allocated from the pool of its type.
+    template <typename T = Enable>
+    using Pooled = std::unique_ptr<T, PoolDeleter>;
+
+    /**
+     * Constructs an object of the type T using the pool of the type.
+     * @param args Arguments passed to the constructor of T.
+     * @returns Owning pointer to the object.
+     */
+    template <typename T, typename... Args>
+    [[nodiscard]] Pooled<T> make_pooled(Args&&... args) {
+        auto& pool = Detail::PoolOf<T>();
+        auto* const memory = pool.allocate();
+        try {
+            auto* const object = new (memory) T(std::forward<Args>(args)...);
+            return Pooled<T>(object, PoolDeleter{&Detail::DestroyPooled<T>, object});
+        } catch (...) {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    /**
+     * Default constructs an object of the registered type described by the passed entry.
+     * The object is adjusted into T using the ancestor table of the created type.
+     * @tparam T The type to return the object as.
+     * @returns Owning pointer to the object, nullptr in case the type is not default
+     * constructible or not an instance of T.
+     */
+    template <typename T = Enable>
+    [[nodiscard]] Pooled<T> create(RegistryEntry const* entry) {
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if constexpr (std::is_same_v<std::remove_const_t<T>, Enable>) {
+            auto* const object = entry->create();
+            if (object == nullptr) {
+                return nullptr;
+            }
+            return Pooled<T>(entry->enable(object), PoolDeleter{entry->destroy, object});
+        } else {
+            if (entry->descriptor->find(TypeInfo<T>::Id()) == entry->descriptor->size) {
+                return nullptr;
+            }
+            auto* const object = entry->create();
+            if (object == nullptr) {
+                return nullptr;
+            }
+            auto* const result = static_cast<T*>(
+                const_cast<void*>(entry->descriptor->cast(TypeInfo<T>::Id(), object)));
+            return Pooled<T>(result, PoolDeleter{entry->destroy, object});
+        }
+    }
+
+    /// Default constructs an object of the registered type identified by the passed id.
+    template <typename T = Enable>
+    [[nodiscard]] Pooled<T> create(TypeId typeId) {
+        return create<T>(Registry::find(typeId));
+    }
+
+    /// Default constructs an object of the registered type with the passed name.
+    template <typename T = Enable>
+    [[nodiscard]] Pooled<T> create(std::string_view name) {
+        return create<T>(Registry::find(name));
+    }
+}  // namespace RTTI
+
+#define RTTI_DETAIL_REGISTRY_CONCAT2(a, b) a##b
+#define RTTI_DETAIL_REGISTRY_CONCAT(a, b) RTTI_DETAIL_REGISTRY_CONCAT2(a, b)
+
+/**
+ * Registers the passed type with the registry, such that objects of the type can be
+ * created by its identifier or name. Has to be used at namespace scope. Entries placed in
+ * the registry section are explicitly aligned to their natural alignment, as the compiler
+ * may otherwise over-align them and break the contiguity of the section.
+ * @param T The type to register, which has to declare its type information.
+ */
+#define RTTI_REGISTER(...) RTTI_DETAIL_REGISTER(__COUNTER__, __VA_ARGS__)
+
+#ifdef RTTI_DETAIL_REGISTRY_SECTION
+    #define RTTI_DETAIL_REGISTER(N, ...)                                                    \
+        [[gnu::used, gnu::section("rtti_registry"),                                        \
+          gnu::aligned(alignof(::RTTI::RegistryEntry))]] static constexpr ::RTTI::RegistryEntry \
+            RTTI_DETAIL_REGISTRY_CONCAT(rttiRegistryEntry, N) =                             \
+                ::RTTI::Detail::MakeRegistryEntry<__VA_ARGS__>()
+#else
+    #define RTTI_DETAIL_REGISTER(N, ...)                                                  \
+        static ::RTTI::RegistryEntry RTTI_DETAIL_REGISTRY_CONCAT(rttiRegistryEntry, N) =  \
+            ::RTTI::Detail::MakeRegistryEntry<__VA_ARGS__>();                             \
+        static ::RTTI::Detail::RegistryLink const RTTI_DETAIL_REGISTRY_CONCAT(            \
+            rttiRegistryLink, N)(RTTI_DETAIL_REGISTRY_CONCAT(rttiRegistryEntry, N))
+#endif
+
+/**
+ * Asserts at compile-time that the identifiers of the passed types are distinct, for
+ * example all types serialized by a protocol.
+ */
+#define RTTI_ASSERT_UNIQUE_IDS(...)                                            \
+    static_assert(::RTTI::Detail::AreUnique(::RTTI::Detail::IdsOf<__VA_ARGS__>()), \
+                  "Type identifier collision between the passed types.")
@@ -24,21 +24,43 @@
 
 #pragma once
 
-#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <type_traits>
+#include <utility>
 
 #include "hash.hh"
 
-namespace RTTI {
-    template <typename T>
-    constexpr std::string_view TypeName();
-    
-    template <>
-    constexpr std::string_view TypeName<void>()
-    { return "void"; }
+/// Maximum number of types that can be assigned a dense type index. Queries for types
+/// with an index beyond the capacity fall back to a lookup by type identifier.
+#ifndef RTTI_TYPE_INDEX_CAPACITY
+    #define RTTI_TYPE_INDEX_CAPACITY 512
+#endif
+
+/// Width of the type identifiers in bits, either 32 or 64. Wider identifiers make hash
+/// collisions between the names of the types in large binaries unlikely.
+#ifndef RTTI_TYPEID_BITS
+    #define RTTI_TYPEID_BITS 32
+#endif
+
+#if RTTI_TYPEID_BITS != 32 && RTTI_TYPEID_BITS != 64
+    #error "RTTI_TYPEID_BITS must be either 32 or 64"
+#endif
+
+/// Number of (dynamic type, target type) pairs each thread counts when RTTI_ENABLE_STATS is
+/// defined, further pairs are counted as dropped.
+#ifndef RTTI_STATS_CAPACITY
+    #define RTTI_STATS_CAPACITY 256
+#endif
 
+#ifdef RTTI_ENABLE_STATS
+    #include <map>
+    #include <mutex>
+    #include <string_view>
+#endif
+
+namespace RTTI {
     namespace Detail { 
         template <typename T>
         constexpr std::string_view WrappedTypeName()  {
@@ -52,31 +74,808 @@ namespace RTTI {
         }
 
         constexpr std::size_t WrappedTypeNamePrefixLength() { 
-            return WrappedTypeName<void>().find(TypeName<void>()); 
+            return WrappedTypeName<void>().find("void"); 
         }
         
         constexpr std::size_t WrappedTypeNameSuffixLength() { 
             return WrappedTypeName<void>().length() 
                 - WrappedTypeNamePrefixLength() 
-                - TypeName<void>().length();
+                - std::string_view("void").length();
         }
+
+        /// Returns the type string of the type T as spelled by the compiler.
+        template <typename T>
+        constexpr std::string_view RawTypeName() {
+            constexpr auto wrappedTypeName = WrappedTypeName<T>();
+            constexpr auto prefixLength = WrappedTypeNamePrefixLength();
+            constexpr auto suffixLength = WrappedTypeNameSuffixLength();
+            constexpr auto typeNameLength = wrappedTypeName.length() - prefixLength - suffixLength;
+            return wrappedTypeName.substr(prefixLength, typeNameLength);
+        }
+
+        constexpr bool IsIdentifierChar(char c) noexcept {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                   c == '_';
+        }
+
+        constexpr bool IsDigit(char c) noexcept {
+            return c >= '0' && c <= '9';
+        }
+
+        /// Checks whether the string str occurs in the string raw at the position pos.
+        constexpr bool StartsWith(std::string_view raw, std::size_t pos,
+                                  std::string_view str) noexcept {
+            if (raw.size() - pos < str.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < str.size(); ++i) {
+                if (raw[pos + i] != str[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Spellings which differ between compilers and their canonical replacement.
+        struct Spelling {
+            std::string_view from;
+            std::string_view to;
+        };
+
+        constexpr Spelling CanonicalSpellings[] = {
+            {"(anonymous namespace)", "{anonymous}"},
+            {"long long unsigned int", "unsigned long long"},
+            {"long long int", "long long"},
+            {"long unsigned int", "unsigned long"},
+            {"long int", "long"},
+            {"short unsigned int", "unsigned short"},
+            {"short int", "short"},
+            {"__int128 unsigned", "unsigned __int128"},
+            {"__cxx11::", ""},
+            {"__1::", ""},
+        };
+
+        /**
+         * Rewrites a type string as spelled by the compiler into its canonical form, which
+         * is the same for GCC and Clang: whitespace is only kept between two identifiers,
+         * the inline namespaces of the standard libraries are removed, integer literals
+         * lose their suffixes and the spellings of the anonymous namespace and of the
+         * integer types are unified, e.g. "long unsigned int" becomes "unsigned long".
+         * @param raw The type string as spelled by the compiler.
+         * @param out Buffer receiving the canonical type string, may be a nullptr.
+         * @returns Length of the canonical type string.
+         */
+        constexpr std::size_t CanonicalizeTypeName(std::string_view raw, char* out) noexcept {
+            std::size_t length = 0;
+            bool identifier = false;
+            for (std::size_t i = 0; i < raw.size();) {
+                auto const c = raw[i];
+
+                // Only the few characters that may start a rewrite take the slow path,
+                // constexpr evaluation is slow enough for the common case to matter.
+                if (c == ' ') {
+                    if (identifier && i + 1 < raw.size() && IsIdentifierChar(raw[i + 1])) {
+                        if (out != nullptr) {
+                            out[length] = c;
+                        }
+                        ++length;
+                    }
+                    identifier = false;
+                    ++i;
+                    continue;
+                }
+
+                if (!identifier && (c == '(' || c == 'l' || c == 's' || c == '_')) {
+                    bool replaced = false;
+                    for (auto const& spelling : CanonicalSpellings) {
+                        if (c != spelling.from[0] || !StartsWith(raw, i, spelling.from)) {
+                            continue;
+                        }
+                        auto const end = i + spelling.from.size();
+                        if (end == raw.size() || !IsIdentifierChar(raw[end]) ||
+                            spelling.from.back() == ':') {
+                            for (auto const r : spelling.to) {
+                                if (out != nullptr) {
+                                    out[length] = r;
+                                }
+                                ++length;
+                            }
+                            identifier = !spelling.to.empty() && IsIdentifierChar(spelling.to.back());
+                            i = end;
+                            replaced = true;
+                            break;
+                        }
+                    }
+                    if (replaced) {
+                        continue;
+                    }
+                }
+
+                if (!identifier && IsDigit(c)) {
+                    auto digits = i;
+                    while (digits < raw.size() && IsDigit(raw[digits])) {
+                        ++digits;
+                    }
+                    auto suffix = digits;
+                    while (suffix < raw.size() && (raw[suffix] == 'u' || raw[suffix] == 'U' ||
+                                                   raw[suffix] == 'l' || raw[suffix] == 'L')) {
+                        ++suffix;
+                    }
+                    if (suffix == raw.size() || !IsIdentifierChar(raw[suffix])) {
+                        for (; i < digits; ++i) {
+                            if (out != nullptr) {
+                                out[length] = raw[i];
+                            }
+                            ++length;
+                        }
+                        identifier = true;
+                        i = suffix;
+                        continue;
+                    }
+                }
+
+                if (out != nullptr) {
+                    out[length] = c;
+                }
+                ++length;
+                identifier = IsIdentifierChar(c);
+                ++i;
+            }
+            return length;
+        }
+
+        /// Canonical type string of the type T, stored null terminated. The canonical form
+        /// is never longer than the spelling of the compiler.
+        template <typename T>
+        struct CanonicalTypeName {
+            static constexpr std::string_view Raw = RawTypeName<T>();
+
+            struct Storage {
+                std::array<char, Raw.size() + 1> chars;
+                std::size_t length;
+            };
+
+            static constexpr Storage Value = [] {
+                Storage value{};
+                value.length = CanonicalizeTypeName(Raw, value.chars.data());
+                return value;
+            }();
+        };
     }
 
+    /**
+     * Returns the canonical type string of the type T. Unlike the spelling of the
+     * compiler the canonical form is the same across GCC, Clang and language standards,
+     * such that the type identifiers derived from it can be shared between binaries built
+     * using different toolchains. User defined inline namespaces are still spelled
+     * differently, GCC includes them while Clang omits them. Defining RTTI_RAW_TYPE_NAMES
+     * returns the spelling of the compiler instead.
+     * @returns Type string
+     */
     template <typename T>
     constexpr std::string_view TypeName() {
-        constexpr auto wrappedTypeName = Detail::WrappedTypeName<T>();
-        constexpr auto prefixLength = Detail::WrappedTypeNamePrefixLength();
-        constexpr auto suffixLength = Detail::WrappedTypeNameSuffixLength();
-        constexpr auto typeNameLength = wrappedTypeName.length() - prefixLength - suffixLength;
-        return wrappedTypeName.substr(prefixLength, typeNameLength);
+#ifdef RTTI_RAW_TYPE_NAMES
+        return Detail::RawTypeName<T>();
+#else
+        constexpr auto const& value = Detail::CanonicalTypeName<T>::Value;
+        return std::string_view(value.chars.data(), value.length);
+#endif
     }
 
     /// TypeId type definition
+#if RTTI_TYPEID_BITS == 64
+    using TypeId = std::uint64_t;
+#else
     using TypeId = std::uint32_t;
+#endif
+
+    /**
+     * Hashes a type name into a type identifier. FNV1a is used by default, xxHash in case
+     * RTTI_USE_XXHASH is defined, both in the width selected by RTTI_TYPEID_BITS. Can be
+     * used at runtime to look up types by names read from a file or the network.
+     * @param name The type name, as returned by TypeName().
+     * @returns Type identifier
+     */
+    [[nodiscard]] constexpr TypeId HashTypeName(std::string_view name) noexcept {
+#if defined(RTTI_USE_XXHASH) && RTTI_TYPEID_BITS == 64
+        return Hash::XXH64(name);
+#elif defined(RTTI_USE_XXHASH)
+        return Hash::XXH32(name);
+#elif RTTI_TYPEID_BITS == 64
+        return Hash::FNV1a64(name);
+#else
+        return Hash::FNV1a(name);
+#endif
+    }
 
     /// Forward declaration of the Enable base.
     struct Enable;
 
+    /// Forward declaration of the TypeInfo structure.
+    template <typename This, typename... Parents>
+    struct TypeInfo;
+
+    namespace Detail {
+        /// Compile-time list of types.
+        template <typename... Ts>
+        struct TypeList {};
+
+        /// Checks whether the type T is a member of the passed type list.
+        template <typename T, typename List>
+        struct Contains;
+
+        template <typename T, typename... Ts>
+        struct Contains<T, TypeList<Ts...>> : std::bool_constant<(... || std::is_same_v<T, Ts>)> {};
+
+        /// Appends the types Ts to the list, skipping types which are already a member.
+        template <typename List, typename... Ts>
+        struct AppendUnique {
+            using type = List;
+        };
+
+        template <typename... Ls, typename T, typename... Ts>
+        struct AppendUnique<TypeList<Ls...>, T, Ts...> {
+            using type = typename AppendUnique<
+                std::conditional_t<Contains<T, TypeList<Ls...>>::value, TypeList<Ls...>,
+                                   TypeList<Ls..., T>>,
+                Ts...>::type;
+        };
+
+        /// Merges the passed type lists into the first one while preserving the order
+        /// of first occurrence and dropping duplicates.
+        template <typename List, typename... Lists>
+        struct Merge {
+            using type = List;
+        };
+
+        template <typename List, typename... Ts, typename... Lists>
+        struct Merge<List, TypeList<Ts...>, Lists...> {
+            using type = typename Merge<typename AppendUnique<List, Ts...>::type, Lists...>::type;
+        };
+
+        /// Type erased upcast from the most specialized type into one of its ancestors.
+        using Caster = void const* (*)(void const*) noexcept;
+
+        template <typename T, typename Ancestor>
+        void const*
+        Upcast(void const* ptr) noexcept {
+            return static_cast<Ancestor const*>(static_cast<T const*>(ptr));
+        }
+
+        /// Returns the number of bits required to index n slots.
+        constexpr unsigned Log2(std::size_t n) noexcept {
+            unsigned bits = 0;
+            while ((std::size_t{1} << bits) < n) {
+                ++bits;
+            }
+            return bits;
+        }
+
+        /**
+         * Checks whether a pointer to From can be converted into a pointer to To using a
+         * static_cast, which is not the case for downcasts through a virtual base.
+         */
+        template <typename From, typename To, typename = void>
+        struct IsStaticCastable : std::false_type {};
+
+        template <typename From, typename To>
+        struct IsStaticCastable<From, To,
+                                std::void_t<decltype(static_cast<To*>(std::declval<From*>()))>>
+            : std::true_type {};
+
+        /**
+         * Multiplicative hash which maps a known set of type identifiers onto distinct
+         * slots of a table with 2^bits entries.
+         */
+        struct PerfectHash {
+            TypeId multiplier;
+            unsigned bits;
+            bool valid;
+
+            [[nodiscard]] constexpr std::size_t operator()(TypeId typeId) const noexcept {
+                constexpr unsigned width = sizeof(TypeId) * 8;
+                return bits == 0 ? 0
+                                 : static_cast<std::size_t>(
+                                       static_cast<TypeId>(typeId * multiplier) >> (width - bits));
+            }
+        };
+
+        /**
+         * Searches for a multiplier that hashes the passed identifiers without collisions,
+         * growing the table up to eight times the minimal size.
+         * @param ids The set of distinct identifiers to be hashed.
+         * @returns The resulting hash function, marked invalid in case none was found.
+         */
+        template <std::size_t N>
+        constexpr PerfectHash FindPerfectHash(std::array<TypeId, N> const& ids) noexcept {
+            constexpr unsigned minBits = Log2(N);
+            constexpr unsigned maxBits = minBits + 3;
+
+            for (unsigned bits = minBits; bits <= maxBits; ++bits) {
+                auto multiplier = static_cast<TypeId>(UINT64_C(0x9E3779B97F4A7C15));
+                for (std::size_t attempt = 0; attempt < 256; ++attempt) {
+                    PerfectHash const hash{multiplier, bits, true};
+                    std::array<bool, (std::size_t{1} << maxBits)> used{};
+                    bool collision = false;
+                    for (std::size_t i = 0; i < N && !collision; ++i) {
+                        auto const slot = hash(ids[i]);
+                        collision = used[slot];
+                        used[slot] = true;
+                    }
+                    if (!collision) {
+                        return hash;
+                    }
+                    multiplier = static_cast<TypeId>(multiplier * UINT64_C(6364136223846793005) +
+                                                     UINT64_C(1442695040888963407)) |
+                                 1;
+                }
+            }
+            return PerfectHash{0, 0, false};
+        }
+
+        /// Checks whether all passed identifiers are unique.
+        template <std::size_t N>
+        constexpr bool AreUnique(std::array<TypeId, N> const& ids) noexcept {
+            for (std::size_t i = 0; i < N; ++i) {
+                for (std::size_t j = i + 1; j < N; ++j) {
+                    if (ids[i] == ids[j]) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// Returns the smallest identifier which is not part of the passed set.
+        template <std::size_t N>
+        constexpr TypeId UnusedId(std::array<TypeId, N> const& ids) noexcept {
+            TypeId id = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (ids[i] == id) {
+                    ++id;
+                    i = static_cast<std::size_t>(-1);
+                }
+            }
+            return id;
+        }
+
+        /// Counter from which dense type indices are handed out. Constant initialized, hence
+        /// free of static initialization order issues.
+        inline std::atomic<std::size_t> typeIndexCounter{0};
+
+        /**
+         * Returns the dense index of the type T. Indices are assigned on first use,
+         * starting at zero, in a thread-safe manner.
+         * @returns Type index
+         */
+        template <typename T>
+        [[nodiscard]] std::size_t TypeIndex() noexcept {
+            static std::size_t const index =
+                typeIndexCounter.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        /**
+         * Fixed capacity bitset of dense type indices.
+         */
+        struct TypeIndexSet {
+            static constexpr std::size_t Capacity = RTTI_TYPE_INDEX_CAPACITY;
+
+            std::array<std::uint64_t, (Capacity + 63) / 64> words{};
+
+            constexpr void insert(std::size_t index) noexcept {
+                if (index < Capacity) {
+                    words[index / 64] |= std::uint64_t{1} << (index % 64);
+                }
+            }
+
+            [[nodiscard]] constexpr bool contains(std::size_t index) const noexcept {
+                return (words[index / 64] >> (index % 64)) & 1;
+            }
+        };
+
+#ifdef RTTI_ENABLE_STATS
+        /**
+         * Counters of the casts and type checks performed on objects, enabled by defining
+         * RTTI_ENABLE_STATS. Each thread counts into its own table, such that counting
+         * costs no more than a few uncontended stores. The tables of all threads are
+         * summed by RTTI::Stats::Collect() from stats.hh.
+         */
+        namespace Stats {
+            static_assert((RTTI_STATS_CAPACITY & (RTTI_STATS_CAPACITY - 1)) == 0,
+                          "RTTI_STATS_CAPACITY must be a power of two.");
+
+            /// Counters of a (dynamic type, target type) pair, only written by its thread.
+            struct Counter {
+                std::atomic<bool> used{false};
+                std::atomic<TypeId> dynamic{0};
+                std::atomic<TypeId> target{0};
+                std::atomic<std::uint64_t> hits{0};
+                std::atomic<std::uint64_t> misses{0};
+                std::atomic<std::uint64_t> visited{0};
+            };
+
+            /// Counter table of a single thread, padded to whole cache lines.
+            struct alignas(64) ThreadCounters {
+                std::array<Counter, RTTI_STATS_CAPACITY> counters;
+                std::atomic<std::uint64_t> dropped{0};
+                ThreadCounters* next = nullptr;
+            };
+
+            /// Summed counters of a (dynamic type, target type) pair.
+            struct Totals {
+                std::uint64_t hits = 0;
+                std::uint64_t misses = 0;
+                std::uint64_t visited = 0;
+            };
+
+            /// Tables of the running threads, the totals of exited threads and type names.
+            struct Registry {
+                std::mutex mutex;
+                ThreadCounters* threads = nullptr;
+                std::map<std::pair<TypeId, TypeId>, Totals> exited;
+                std::uint64_t dropped = 0;
+                std::map<TypeId, std::string_view> names;
+            };
+
+            /// Returns the registry, which is never destroyed such that threads exiting
+            /// after main can still hand in their counters.
+            inline Registry& GetRegistry() noexcept {
+                static auto* const registry = new Registry();
+                return *registry;
+            }
+
+            /// Increments a counter only written by the calling thread.
+            inline void Add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+                counter.store(counter.load(std::memory_order_relaxed) + value,
+                              std::memory_order_relaxed);
+            }
+
+            /// Registers the counter table of the calling thread for its lifetime.
+            class ThreadRegistration {
+            public:
+                ThreadRegistration() : _counters(new ThreadCounters()) {
+                    auto& registry = GetRegistry();
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    _counters->next = registry.threads;
+                    registry.threads = _counters;
+                }
+
+                ~ThreadRegistration() {
+                    auto& registry = GetRegistry();
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    for (auto** link = &registry.threads; *link != nullptr;
+                         link = &(*link)->next) {
+                        if (*link == _counters) {
+                            *link = _counters->next;
+                            break;
+                        }
+                    }
+                    for (auto const& counter : _counters->counters) {
+                        if (counter.used.load(std::memory_order_relaxed)) {
+                            auto& totals = registry.exited[{counter.dynamic, counter.target}];
+                            totals.hits += counter.hits;
+                            totals.misses += counter.misses;
+                            totals.visited += counter.visited;
+                        }
+                    }
+                    registry.dropped += _counters->dropped;
+                    delete _counters;
+                }
+
+                ThreadRegistration(ThreadRegistration const&) = delete;
+                ThreadRegistration& operator=(ThreadRegistration const&) = delete;
+
+                [[nodiscard]] ThreadCounters& counters() noexcept {
+                    return *_counters;
+                }
+
+            private:
+                ThreadCounters* _counters;
+            };
+
+            /**
+             * Registers the name of the type identified by the passed id, used to label the
+             * counters.
+             * @returns Always true, such that it can initialize a static.
+             */
+            inline bool Name(TypeId typeId, std::string_view name) {
+                auto& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.names.emplace(typeId, name);
+                return true;
+            }
+
+            /// Registers the name of the type T once.
+            template <typename T>
+            void Name() {
+                static bool const named = Name(TypeInfo<T>::Id(), TypeInfo<T>::Name());
+                (void)named;
+            }
+
+            /**
+             * Counts a lookup of the target type in the ancestors of the dynamic type.
+             * @param dynamic The identifier of the type of the object.
+             * @param dynamicName The name of the type of the object.
+             * @param target The identifier of the type looked up.
+             * @param hit Whether the object is an instance of the target type.
+             * @param visited The number of ancestor table entries visited.
+             */
+            inline void Record(TypeId dynamic, std::string_view dynamicName, TypeId target,
+                               bool hit, std::size_t visited) noexcept {
+                thread_local ThreadRegistration registration;
+                auto& table = registration.counters();
+                auto slot = static_cast<std::size_t>(
+                    ((static_cast<std::uint64_t>(dynamic) * UINT64_C(0x9E3779B97F4A7C15)) ^
+                     static_cast<std::uint64_t>(target)) *
+                    UINT64_C(0xFF51AFD7ED558CCD) >> 32);
+                for (std::size_t probe = 0; probe < RTTI_STATS_CAPACITY; ++probe, ++slot) {
+                    auto& counter = table.counters[slot & (RTTI_STATS_CAPACITY - 1)];
+                    if (!counter.used.load(std::memory_order_relaxed)) {
+                        if (!dynamicName.empty()) {
+                            Name(dynamic, dynamicName);
+                        }
+                        counter.dynamic.store(dynamic, std::memory_order_relaxed);
+                        counter.target.store(target, std::memory_order_relaxed);
+                        counter.used.store(true, std::memory_order_release);
+                    } else if (counter.dynamic.load(std::memory_order_relaxed) != dynamic ||
+                               counter.target.load(std::memory_order_relaxed) != target) {
+                        continue;
+                    }
+                    Add(hit ? counter.hits : counter.misses, 1);
+                    Add(counter.visited, visited);
+                    return;
+                }
+                Add(table.dropped, 1);
+            }
+        }  // namespace Stats
+#endif
+
+        /**
+         * Constant description of a type in a hierarchy. Holds the identifier and name
+         * of the type together with its flattened ancestor table.
+         */
+        struct TypeDescriptor {
+            TypeId id;
+            std::string_view name;
+
+            /// Number of entries in the ancestor table, including the type itself.
+            std::size_t size;
+            TypeId const* ids;
+            Caster const* casters;
+
+            /// Perfect hash table mapping ancestor identifiers onto table indices.
+            PerfectHash hash;
+            TypeId const* slotIds;
+            std::size_t const* slotIndices;
+
+            /// Returns the set of dense type indices of all ancestors.
+            TypeIndexSet const& (*indices)() noexcept;
+
+            /// Descriptors of the direct parents of the type.
+            std::size_t parentCount;
+            TypeDescriptor const* const* parents;
+
+            /**
+             * Finds the index of the ancestor identified by the passed type id.
+             * @param typeId The identifier of the ancestor to search for.
+             * @returns Index of the ancestor in the table, size if not found.
+             */
+            [[nodiscard]] constexpr std::size_t find(TypeId typeId) const noexcept {
+                if (hash.valid) {
+                    auto const slot = hash(typeId);
+                    return slotIds[slot] == typeId ? slotIndices[slot] : size;
+                }
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (ids[i] == typeId) {
+                        return i;
+                    }
+                }
+                return size;
+            }
+
+            /**
+             * Casts the passed object of the described type into the ancestor identified
+             * by the passed type id.
+             * @param typeId The identifier of the type to cast the object into.
+             * @param object Pointer to an object of the described type.
+             * @returns Pointer to the ancestor, nullptr if not found.
+             */
+            [[nodiscard]] void const* cast(TypeId typeId, void const* object) const noexcept {
+                auto const index = find(typeId);
+#ifdef RTTI_ENABLE_STATS
+                Stats::Record(id, name, typeId, index != size, probes(index));
+#endif
+                return index != size ? casters[index](object) : nullptr;
+            }
+
+            /// Returns the number of ancestor table entries visited by find for its result.
+            [[nodiscard]] constexpr std::size_t probes(std::size_t index) const noexcept {
+                return hash.valid ? 1 : (index == size ? size : index + 1);
+            }
+        };
+
+        /// Descriptor of the most specialized type of an object together with the object.
+        struct Self {
+            TypeDescriptor const* descriptor;
+            void const* object;
+        };
+
+        /**
+         * Perfect hash table over a fixed set of type identifiers, generated at compile-time.
+         * Each slot holds the identifier hashed into it and the position of that identifier
+         * in Ids. Unused slots hold an identifier not in Ids and the position Size.
+         */
+        template <TypeId... Ids>
+        struct SlotTable {
+            static constexpr std::size_t Size = sizeof...(Ids);
+
+            static constexpr PerfectHash Hash = FindPerfectHash(std::array<TypeId, Size>{Ids...});
+
+            static constexpr std::size_t Slots = std::size_t{1} << Hash.bits;
+
+            static constexpr std::array<TypeId, Slots> SlotIds = [] {
+                constexpr std::array<TypeId, Size> ids = {Ids...};
+                std::array<TypeId, Slots> slotIds{};
+                for (auto& slotId : slotIds) {
+                    slotId = UnusedId(ids);
+                }
+                for (std::size_t i = 0; i < Size; ++i) {
+                    slotIds[Hash(ids[i])] = ids[i];
+                }
+                return slotIds;
+            }();
+
+            static constexpr std::array<std::size_t, Slots> SlotIndices = [] {
+                constexpr std::array<TypeId, Size> ids = {Ids...};
+                std::array<std::size_t, Slots> slotIndices{};
+                for (auto& slotIndex : slotIndices) {
+                    slotIndex = Size;
+                }
+                for (std::size_t i = 0; i < Size; ++i) {
+                    slotIndices[Hash(ids[i])] = i;
+                }
+                return slotIndices;
+            }();
+        };
+
+        /**
+         * Fixed set of type identifiers sorted in ascending order at compile-time, searched
+         * using a binary search. Used where no perfect hash is required to exist.
+         */
+        template <TypeId... Ids>
+        struct SortedIds {
+            static constexpr std::size_t Size = sizeof...(Ids);
+
+            /// Identifier and its position in Ids.
+            struct Entry {
+                TypeId id;
+                std::size_t index;
+            };
+
+            static constexpr std::array<Entry, Size> Entries = [] {
+                std::array<Entry, Size> entries = {{{Ids, 0}...}};
+                for (std::size_t i = 0; i < Size; ++i) {
+                    entries[i].index = i;
+                }
+                for (std::size_t i = 1; i < Size; ++i) {
+                    for (std::size_t j = i; j > 0 && entries[j - 1].id > entries[j].id; --j) {
+                        auto const tmp = entries[j];
+                        entries[j] = entries[j - 1];
+                        entries[j - 1] = tmp;
+                    }
+                }
+                return entries;
+            }();
+
+            /**
+             * Finds the position of the passed identifier in Ids.
+             * @returns The position, Size if not found.
+             */
+            [[nodiscard]] static constexpr std::size_t Find(TypeId typeId) noexcept {
+                std::size_t first = 0;
+                std::size_t count = Size;
+                while (count > 0) {
+                    auto const step = count / 2;
+                    if (Entries[first + step].id < typeId) {
+                        first += step + 1;
+                        count -= step + 1;
+                    } else {
+                        count = step;
+                    }
+                }
+                return first < Size && Entries[first].id == typeId ? Entries[first].index : Size;
+            }
+        };
+
+        /**
+         * Orders the positions of the passed keys from the largest to the smallest key,
+         * keeping the order of positions with equal keys.
+         */
+        template <std::size_t N>
+        constexpr std::array<std::size_t, N> DescendingOrder(
+            std::array<std::size_t, N> const& keys) noexcept {
+            std::array<std::size_t, N> order{};
+            for (std::size_t i = 0; i < N; ++i) {
+                auto j = i;
+                for (; j > 0 && keys[order[j - 1]] < keys[i]; --j) {
+                    order[j] = order[j - 1];
+                }
+                order[j] = i;
+            }
+            return order;
+        }
+
+        /**
+         * Flattened table of all ancestors of the type T, including T itself. Each entry
+         * holds the identifier of the ancestor and the adjustment that casts a pointer of
+         * type T into a pointer to the ancestor. Adjustments are generated upcasts rather
+         * than raw offsets such that virtual bases are resolved through the object itself.
+         * Identifiers are placed in a perfect hash table such that a lookup costs a single
+         * probe regardless of the depth or width of the hierarchy.
+         */
+        template <typename T, typename List, typename ParentList>
+        struct AncestorTable;
+
+        template <typename T, typename... Ancestors, typename... Parents>
+        struct AncestorTable<T, TypeList<Ancestors...>, TypeList<Parents...>> {
+            static constexpr std::size_t Size = sizeof...(Ancestors);
+
+            static constexpr std::array<TypeId, Size> Ids = {TypeInfo<Ancestors>::Id()...};
+
+            static constexpr std::array<Caster, Size> Casters = {&Upcast<T, Ancestors>...};
+
+            static_assert(AreUnique(Ids), "Type identifier collision within the hierarchy.");
+
+            using Table = SlotTable<TypeInfo<Ancestors>::Id()...>;
+
+            static constexpr PerfectHash Hash = Table::Hash;
+
+            /**
+             * Returns the set holding the dense type indices of all ancestors. The set
+             * is built once on first use.
+             * @returns Ancestor index set
+             */
+            [[nodiscard]] static TypeIndexSet const& Indices() noexcept {
+                static TypeIndexSet const indices = [] {
+#ifdef RTTI_ENABLE_STATS
+                    Stats::Name(TypeInfo<T>::Id(), TypeInfo<T>::Name());
+#endif
+                    TypeIndexSet set;
+                    (set.insert(TypeIndex<Ancestors>()), ...);
+                    return set;
+                }();
+                return indices;
+            }
+
+            static constexpr std::array<TypeDescriptor const*, sizeof...(Parents)>
+                ParentDescriptors = {&Parents::TypeInfo::Descriptor()...};
+
+            static constexpr TypeDescriptor Descriptor = {
+                TypeInfo<T>::Id(),
+                TypeInfo<T>::Name(),
+                Size,
+                Ids.data(),
+                Casters.data(),
+                Hash,
+                Table::SlotIds.data(),
+                Table::SlotIndices.data(),
+                &Indices,
+                sizeof...(Parents),
+                ParentDescriptors.data(),
+            };
+
+            /**
+             * Finds the index of the ancestor identified by the passed type id.
+             * @param typeId The identifier of the ancestor to search for.
+             * @returns Index of the ancestor in the table, Size if not found.
+             */
+            [[nodiscard]] static constexpr std::size_t Find(TypeId typeId) noexcept {
+                return Descriptor.find(typeId);
+            }
+        };
+    }  // namespace Detail
+
     /**
      * Static typeinfo structure for registering types and accessing their information.
      */
@@ -92,6 +891,14 @@ namespace RTTI {
         static_assert((... && std::is_base_of<Enable, Parents>::value),
                       "One or more parent hierarchies is not based on top of RTTI::Enable.");
 
+        /// Flattened and deduplicated list of this type and all of its ancestors.
+        using Ancestors = typename Detail::Merge<Detail::TypeList<T>,
+                                                 typename Parents::TypeInfo::Ancestors...>::type;
+
+        /// Compile-time generated ancestor lookup table.
+        using AncestorTable =
+            Detail::AncestorTable<T, Ancestors, Detail::TypeList<typename Parents::TypeInfo::T...>>;
+
         /**
          * Returns the type string of the type T.
          * @returns Type string
@@ -105,7 +912,66 @@ namespace RTTI {
          * @returns Type identifier
          */
         [[nodiscard]] static constexpr TypeId Id() noexcept {
-            return Hash::FNV1a(Name());
+            return HashTypeName(Name());
+        }
+
+        /**
+         * Returns the constant descriptor of the type T.
+         * @returns Type descriptor
+         */
+        [[nodiscard]] static constexpr Detail::TypeDescriptor const& Descriptor() noexcept {
+            return AncestorTable::Descriptor;
+        }
+
+        /**
+         * Returns the identifiers of the type T and all of its ancestors, in the order of
+         * the ancestor table. Named apart from Ancestors, which lists the types themselves.
+         * @returns Array of type identifiers
+         */
+        [[nodiscard]] static constexpr auto const& AncestorIds() noexcept {
+            return AncestorTable::Ids;
+        }
+
+        /**
+         * Returns the length of the longest chain of parents from the type T to a root of
+         * its hierarchy, zero for a root.
+         * @returns Depth of the type
+         */
+        [[nodiscard]] static constexpr std::size_t Depth() noexcept {
+            std::size_t const depths[] = {0, Parents::TypeInfo::Depth() + 1 ...};
+            std::size_t depth = 0;
+            for (auto const parent : depths) {
+                depth = parent > depth ? parent : depth;
+            }
+            return depth;
+        }
+
+        /**
+         * Returns the number of paths from the type T to itself and its ancestors, which is
+         * the number of types a recursive walk of the parents visits. Ancestors shared by
+         * several parents, such as the apex of a diamond, are counted once per path.
+         * @returns Number of paths
+         */
+        [[nodiscard]] static constexpr std::size_t Paths() noexcept {
+            return (std::size_t{1} + ... + Parents::TypeInfo::Paths());
+        }
+
+        /**
+         * Returns the number of ancestor table entries a cast from the type T visits at
+         * most, which is the cost of a miss. One if the perfect hash was found, the number
+         * of ancestors in case the table falls back to a linear scan.
+         * @returns Worst-case number of visited entries
+         */
+        [[nodiscard]] static constexpr std::size_t NodesVisitedWorstCase() noexcept {
+            return Descriptor().probes(AncestorTable::Size);
+        }
+
+        /**
+         * Returns the dense index of the type T.
+         * @returns Type index
+         */
+        [[nodiscard]] static std::size_t Index() noexcept {
+            return Detail::TypeIndex<T>();
         }
 
         /**
@@ -114,39 +980,30 @@ namespace RTTI {
          * @returns True in case a match was found.
          */
         [[nodiscard]] static constexpr bool Is(TypeId typeId) noexcept {
-            return (Id() == typeId) || (... || (Parents::TypeInfo::Is(typeId)));
+            return AncestorTable::Find(typeId) != AncestorTable::Size;
         }
 
         /**
-         * Walks the dependency hierarchy of the object in search of the type identified
-         * by the passed type id. In case found casts the passed pointer into the passed
+         * Looks up the type identified by the passed type id in the flattened ancestor
+         * table of the type. In case found casts the passed pointer into the passed
          * type. If no match can be found the function returns a nullptr.
-         * @tparam T The type of the most specialized type in the dependency hierarchy.
+         * @tparam U The type of the passed pointer, which is this type.
          * @param typeId The identifier of the type to cast the object into.
          * @returns Valid pointer to instance of requested type if the object is a
          * direct descendance of the type identified by the passed type id. Otherwise
          * the value returned is a nullptr.
          */
-        template <typename T>
-        [[nodiscard]] static void const* DynamicCast(TypeId typeId, T const* ptr) noexcept {
-            // Check whether the current type matches the requested type.
-            if (Id() == typeId) {
-                // Cast the passed pointer in to the current type and stop
-                // the recursion.
-                return static_cast<This const*>(ptr);
-            }
-
-            // The current type does not match, recursively invoke the method
-            // for all directly related parent types.
-            std::array<void const*, sizeof...(Parents)> ptrs = {
-                Parents::TypeInfo::DynamicCast(typeId, ptr)...};
-
-            // Check whether the traversal up the dependency hierarchy returned a pointer
-            // that is not null.
-            auto it = std::find_if(ptrs.begin(), ptrs.end(), [](void const* ptr) {
-                return ptr != nullptr;
-            });
-            return (it != ptrs.end()) ? *it : nullptr;
+        template <typename U>
+        [[nodiscard]] static void const* DynamicCast(TypeId typeId, U const* ptr) noexcept {
+            auto const index = AncestorTable::Find(typeId);
+#ifdef RTTI_ENABLE_STATS
+            Detail::Stats::Record(Id(), Name(), typeId, index != AncestorTable::Size,
+                                  Descriptor().probes(index));
+#endif
+            if (index == AncestorTable::Size) {
+                return nullptr;
+            }
+            return AncestorTable::Casters[index](static_cast<T const*>(ptr));
         }
     };
 
@@ -156,11 +1013,29 @@ namespace RTTI {
     struct Enable {
         virtual ~Enable() = default;
 
+#ifdef RTTI_USE_TYPE_DESCRIPTOR
+        /**
+         * Returns the type identifier of the object.
+         * @returns Type identifier
+         */
+        [[nodiscard]] TypeId typeId() const noexcept {
+            return _self().descriptor->id;
+        }
+
+        /**
+         * Returns the constant descriptor of the most specialized type of the object.
+         * @returns Type descriptor
+         */
+        [[nodiscard]] Detail::TypeDescriptor const& typeDescriptor() const noexcept {
+            return *_self().descriptor;
+        }
+#else
         /**
          * Returns the type identifier of the object.
          * @returns Type identifier
          */
         [[nodiscard]] virtual TypeId typeId() const noexcept = 0;
+#endif
 
         /**
          * Checks whether the object is a direct or derived instance of
@@ -168,16 +1043,37 @@ namespace RTTI {
          * @tparam The identifier to compare with.
          * @returns True in case a match was found.
          */
-        [[nodiscard]] virtual bool isById(TypeId typeId) const noexcept = 0;
+        [[nodiscard]] bool isById(TypeId typeId) const noexcept {
+            return _cast(typeId) != nullptr;
+        }
 
         /**
          * Checks whether the object is an instance of child instance of
-         * the passed type.
+         * the passed type. Tests the dense index of the type against the
+         * ancestor index set of the object.
          * @tparam The type to compare the identifier with.
          * @returns True in case a match was found.
          */
         template <typename T>
         [[nodiscard]] bool is() const noexcept {
+            auto const index = TypeInfo<T>::Index();
+#ifdef RTTI_ENABLE_STATS
+            Detail::Stats::Name<T>();
+            if (index < Detail::TypeIndexSet::Capacity) {
+                auto const hit = _typeIndices().contains(index);
+    #ifdef RTTI_USE_TYPE_DESCRIPTOR
+                auto const dynamicName = typeDescriptor().name;
+    #else
+                auto const dynamicName = std::string_view();
+    #endif
+                Detail::Stats::Record(typeId(), dynamicName, TypeInfo<T>::Id(), hit, 1);
+                return hit;
+            }
+#else
+            if (index < Detail::TypeIndexSet::Capacity) {
+                return _typeIndices().contains(index);
+            }
+#endif
             return isById(TypeInfo<T>::Id());
         }
 
@@ -196,15 +1092,37 @@ namespace RTTI {
          */
         template <typename T>
         [[nodiscard]] T* cast() noexcept {
-            return reinterpret_cast<T*>(const_cast<void*>(_cast(TypeInfo<T>::Id())));
+            return const_cast<T*>(static_cast<Enable const*>(this)->cast<T>());
         }
 
         template <typename T>
         [[nodiscard]] T const* cast() const noexcept {
+#ifdef RTTI_ENABLE_STATS
+            Detail::Stats::Name<T>();
+#endif
             return reinterpret_cast<T const*>(_cast(TypeInfo<T>::Id()));
         }
 
     protected:
+#ifdef RTTI_USE_TYPE_DESCRIPTOR
+        /**
+         * Returns the descriptor of the most specialized type in the dependency
+         * hierarchy together with the object as that type. This is the only
+         * virtual function overloaded in each derivation, all queries are
+         * answered by reading the returned descriptor.
+         * @returns Descriptor and object of the most specialized type.
+         */
+        [[nodiscard]] virtual Detail::Self _self() const noexcept = 0;
+
+        [[nodiscard]] void const* _cast(TypeId typeId) const noexcept {
+            auto const self = _self();
+            return self.descriptor->cast(typeId, self.object);
+        }
+
+        [[nodiscard]] Detail::TypeIndexSet const& _typeIndices() const noexcept {
+            return _self().descriptor->indices();
+        }
+#else
         /**
          * Used to invoke the _dynamic_cast from the most specialized type in the
          * dependency hierarchy by overloaded this function in each derivation of
@@ -215,27 +1133,203 @@ namespace RTTI {
          * the value returned is a nullptr.
          */
         [[nodiscard]] virtual void const* _cast(TypeId typeId) const noexcept = 0;
+
+        /**
+         * Returns the dense type indices of the most specialized type in the
+         * dependency hierarchy and all of its ancestors.
+         * @returns Ancestor index set
+         */
+        [[nodiscard]] virtual Detail::TypeIndexSet const& _typeIndices() const noexcept = 0;
+#endif
     };
+
+    /**
+     * Non-virtual parent type for the root of a single-root RTTI hierarchy. Uses the
+     * "Curiously Recurring Template Idiom", taking the root type as its template argument.
+     * Avoids the virtual base of RTTI::Enable, such that objects do not carry the
+     * adjustment of a virtual base and downcasts from the root can be performed using a
+     * static_cast. Types in the hierarchy may not derive from RTTI::Enable through any
+     * other path, hierarchies requiring multiple RTTI parents should virtually derive from
+     * RTTI::Enable instead.
+     */
+    template <typename Root>
+    struct EnableRoot : Enable {
+        /// The root type of the hierarchy.
+        using RootType = Root;
+
+        /**
+         * Dynamically cast the object to the passed type. Types derived from the root
+         * are resolved by a type check followed by a static_cast from the root, others
+         * are looked up in the dependency hierarchy of the object.
+         *
+         * @tparam T Pointer type to case the object into.
+         * @returns A valid pointer to an instance of the passed type. Nullptr
+         * incase the object instance is not a direct descendence of the passed
+         * type.
+         */
+        template <typename T>
+        [[nodiscard]] T* cast() noexcept {
+            return const_cast<T*>(static_cast<EnableRoot const*>(this)->cast<T>());
+        }
+
+        template <typename T>
+        [[nodiscard]] T const* cast() const noexcept {
+            static_assert(std::is_base_of_v<EnableRoot, Root>,
+                          "The root type is not derived from RTTI::EnableRoot.");
+
+            if constexpr (Detail::IsStaticCastable<Root const, T const>::value) {
+                return is<T>() ? static_cast<T const*>(static_cast<Root const*>(this)) : nullptr;
+            } else {
+                return Enable::cast<T>();
+            }
+        }
+    };
+
+    namespace Detail {
+        /// Resolves the root type of a hierarchy based on RTTI::EnableRoot, void otherwise.
+        template <typename T, typename = void>
+        struct RootOf {
+            using type = void;
+        };
+
+        template <typename T>
+        struct RootOf<T, std::void_t<typename T::RootType>> {
+            using type = typename T::RootType;
+        };
+
+        /// Pointer to T, const qualified in case U is const qualified.
+        template <typename T, typename U>
+        using CastResult = std::conditional_t<std::is_const_v<U>, T const, T>*;
+
+        /**
+         * Casts the passed object by looking up the type in the dependency hierarchy of
+         * the object, bypassing any cast member declared by RTTI_DECLARE_TYPEINFO.
+         */
+        template <typename T, typename U>
+        [[nodiscard]] CastResult<T, U> LookupCast(U* ptr) noexcept {
+            using Root = typename RootOf<std::remove_const_t<U>>::type;
+            if constexpr (std::is_void_v<Root>) {
+                return ptr->Enable::template cast<T>();
+            } else {
+                return ptr->EnableRoot<Root>::template cast<T>();
+            }
+        }
+    }  // namespace Detail
+
+    /**
+     * Dynamically cast the passed object to the passed type. Casts that are known to
+     * succeed based on the static type of the object are resolved at compile-time using
+     * a static_cast. Casts into final types are resolved by a single comparison of the
+     * type identifier of the object. All others are looked up in the dependency hierarchy
+     * of the object.
+     *
+     * @tparam T Type to cast the object into.
+     * @param ptr Pointer to the object, may be a nullptr.
+     * @returns A valid pointer to an instance of the passed type. Nullptr incase the
+     * object instance is not a direct descendence of the passed type.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] Detail::CastResult<T, U> cast(U* ptr) noexcept {
+        using Result = Detail::CastResult<T, U>;
+
+        if constexpr (std::is_base_of_v<T, U> &&
+                      Detail::IsStaticCastable<U const, T const>::value) {
+            return static_cast<Result>(ptr);
+        } else if constexpr (std::is_final_v<T>) {
+            if (ptr == nullptr || ptr->typeId() != TypeInfo<T>::Id()) {
+                return nullptr;
+            }
+            if constexpr (Detail::IsStaticCastable<U const, T const>::value) {
+                return static_cast<Result>(ptr);
+            } else {
+                return Detail::LookupCast<T>(ptr);
+            }
+        } else {
+            return ptr != nullptr ? Detail::LookupCast<T>(ptr) : nullptr;
+        }
+    }
+
+    /**
+     * Checks whether the passed object is an instance of child instance of the passed
+     * type. Checks that are known to succeed based on the static type of the object are
+     * resolved at compile-time.
+     *
+     * @tparam T The type to check for.
+     * @param ptr Pointer to the object, may be a nullptr.
+     * @returns True in case a match was found.
+     */
+    template <typename T, typename U>
+    [[nodiscard]] bool is(U const* ptr) noexcept {
+        if constexpr (std::is_base_of_v<T, U>) {
+            return ptr != nullptr;
+        } else if constexpr (std::is_final_v<T>) {
+            return ptr != nullptr && ptr->typeId() == TypeInfo<T>::Id();
+        } else {
+            return ptr != nullptr && ptr->Enable::template is<T>();
+        }
+    }
 }  // namespace RTTI
 
+/**
+ * Overloads of the virtual interface described by RTTI::Enable, either the single
+ * descriptor accessor or the separate type id, cast and index set accessors.
+ */
+#ifdef RTTI_USE_TYPE_DESCRIPTOR
+    #define RTTI_DETAIL_DECLARE_VIRTUALS()                                                   \
+    protected:                                                                               \
+        [[nodiscard]] virtual RTTI::Detail::Self _self() const noexcept override {           \
+            return {&TypeInfo::Descriptor(), this};                                          \
+        }
+#else
+    #define RTTI_DETAIL_DECLARE_VIRTUALS()                                                   \
+    public:                                                                                  \
+        [[nodiscard]] virtual RTTI::TypeId typeId() const noexcept override {                \
+            return TypeInfo::Id();                                                           \
+        }                                                                                    \
+                                                                                             \
+    protected:                                                                               \
+        [[nodiscard]] virtual void const* _cast(RTTI::TypeId typeId) const noexcept override { \
+            return TypeInfo::DynamicCast(typeId, this);                                      \
+        }                                                                                    \
+        [[nodiscard]] virtual RTTI::Detail::TypeIndexSet const& _typeIndices()               \
+            const noexcept override {                                                        \
+            return TypeInfo::AncestorTable::Indices();                                       \
+        }
+#endif
+
 /**
  * Macro to be called in the body of each type declaration that is to be part of an
  * open hierarchy RTTI structure. The type itself or one or more parents of the type
- * need to have been derived from RTTI::Enable.
+ * need to have been derived from RTTI::Enable. Declares cast<T>() and is<T>() members
+ * which resolve provably successful queries at compile-time based on the type itself.
  * @param T The type it self.
  * @param Parents Variadic number of direct parrent types of the type
  */
-#define RTTI_DECLARE_TYPEINFO(T, ...)                                                      \
-public:                                                                                    \
-    using TypeInfo = RTTI::TypeInfo<T, ##__VA_ARGS__>;                                     \
-    [[nodiscard]] virtual RTTI::TypeId typeId() const noexcept override {                  \
-        return TypeInfo::Id();                                                             \
-    }                                                                                      \
-    [[nodiscard]] virtual bool isById(RTTI::TypeId typeId) const noexcept override {       \
-        return TypeInfo::Is(typeId);                                                       \
-    }                                                                                      \
-                                                                                           \
-protected:                                                                                 \
-    [[nodiscard]] virtual void const* _cast(RTTI::TypeId typeId) const noexcept override { \
-        return TypeInfo::Is(typeId) ? TypeInfo::DynamicCast(typeId, this) : nullptr;       \
-    }
+#define RTTI_DECLARE_TYPEINFO(T, ...)                       \
+public:                                                     \
+    using TypeInfo = RTTI::TypeInfo<T, ##__VA_ARGS__>;      \
+                                                            \
+    template <typename RttiTarget>                          \
+    [[nodiscard]] RttiTarget* cast() noexcept {             \
+        return RTTI::cast<RttiTarget>(this);                \
+    }                                                       \
+    template <typename RttiTarget>                          \
+    [[nodiscard]] RttiTarget const* cast() const noexcept { \
+        return RTTI::cast<RttiTarget>(this);                \
+    }                                                       \
+    template <typename RttiTarget>                          \
+    [[nodiscard]] bool is() const noexcept {                \
+        return RTTI::is<RttiTarget>(this);                  \
+    }                                                       \
+    RTTI_DETAIL_DECLARE_VIRTUALS()
+
+/**
+ * Asserts at compile-time that a cast from the passed type visits at most the passed number
+ * of ancestor table entries, such that changes to the hierarchy do not silently make casts
+ * from hot types more expensive.
+ * @param T The type casts are made from, which has to declare its type information.
+ * @param n The maximum number of visited entries.
+ */
+#define RTTI_MAX_CAST_COST(T, n)                                  \
+    static_assert(T::TypeInfo::NodesVisitedWorstCase() <= (n),   \
+                  "Casts from " #T " exceed their cost budget.")
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rtti.hh"
+#include "type_label.hh"
+
+namespace RTTI {
+    namespace Stats {
+        /// Whether the casts and type checks are counted, i.e. RTTI_ENABLE_STATS is defined.
+#ifdef RTTI_ENABLE_STATS
+        inline constexpr bool Enabled = true;
+#else
+        inline constexpr bool Enabled = false;
+#endif
+
+        /// Counters of the lookups of a target type in the ancestors of a dynamic type.
+        struct Entry {
+            TypeId dynamicId;
+            TypeId targetId;
+
+            /// Names of the types, empty if the type was never named by a query.
+            std::string_view dynamicName;
+            std::string_view targetName;
+
+            std::uint64_t hits;
+            std::uint64_t misses;
+
+            /// Number of ancestor table entries visited by all lookups.
+            std::uint64_t visited;
+        };
+
+        /**
+         * Counters of all threads at a point in time, the entries are sorted by the number of
+         * lookups in descending order.
+         */
+        struct Snapshot {
+            std::vector<Entry> entries;
+
+            /// Number of lookups not counted because the table of the thread was full.
+            std::uint64_t dropped = 0;
+
+            /**
+             * Exports the snapshot as a JSON object holding the entries and the dropped count.
+             * Types without a name are labeled by their identifier.
+             * @returns The JSON document.
+             */
+            [[nodiscard]] std::string toJson() const {
+                std::string json = "{\"enabled\":";
+                json += Enabled ? "true" : "false";
+                json += ",\"dropped\":" + std::to_string(dropped) + ",\"entries\":[";
+                for (std::size_t i = 0; i < entries.size(); ++i) {
+                    auto const& entry = entries[i];
+                    json += i > 0 ? ",{" : "{";
+                    json += "\"dynamic\":";
+                    Detail::AppendTypeLabel(json, entry.dynamicId, entry.dynamicName);
+                    json += ",\"target\":";
+                    Detail::AppendTypeLabel(json, entry.targetId, entry.targetName);
+                    json += ",\"hits\":" + std::to_string(entry.hits);
+                    json += ",\"misses\":" + std::to_string(entry.misses);
+                    json += ",\"visited\":" + std::to_string(entry.visited) + "}";
+                }
+                json += "]}";
+                return json;
+            }
+        };
+
+        /**
+         * Sums the counters of all running threads and of the threads that have exited. The
+         * counters of running threads are read while they may still be counting, hence a
+         * snapshot may miss the lookups of the last moments. Without RTTI_ENABLE_STATS the
+         * snapshot is empty.
+         * @returns Snapshot of the counters.
+         */
+        [[nodiscard]] inline Snapshot Collect() {
+            Snapshot snapshot;
+#ifdef RTTI_ENABLE_STATS
+            auto& registry = Detail::Stats::GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto totals = registry.exited;
+            snapshot.dropped = registry.dropped;
+            for (auto const* thread = registry.threads; thread != nullptr; thread = thread->next) {
+                for (auto const& counter : thread->counters) {
+                    if (counter.used.load(std::memory_order_acquire)) {
+                        auto& sum = totals[{counter.dynamic.load(std::memory_order_relaxed),
+                                            counter.target.load(std::memory_order_relaxed)}];
+                        sum.hits += counter.hits.load(std::memory_order_relaxed);
+                        sum.misses += counter.misses.load(std::memory_order_relaxed);
+                        sum.visited += counter.visited.load(std::memory_order_relaxed);
+                    }
+                }
+                snapshot.dropped += thread->dropped.load(std::memory_order_relaxed);
+            }
+
+            auto const name = [&registry](TypeId typeId) {
+                auto const it = registry.names.find(typeId);
+                return it != registry.names.end() ? it->second : std::string_view();
+            };
+            for (auto const& [ids, sum] : totals) {
+                snapshot.entries.push_back(Entry{ids.first, ids.second, name(ids.first),
+                                                 name(ids.second), sum.hits, sum.misses,
+                                                 sum.visited});
+            }
+            std::stable_sort(snapshot.entries.begin(), snapshot.entries.end(),
+                             [](Entry const& a, Entry const& b) {
+                                 return a.hits + a.misses > b.hits + b.misses;
+                             });
+#endif
+            return snapshot;
+        }
+    }  // namespace Stats
+}  // namespace RTTI
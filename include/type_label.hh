@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /// Appends the passed text, escaping quotes and backslashes for JSON and DOT strings.
+        inline void AppendEscaped(std::string& out, std::string_view text) {
+            for (auto c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                }
+                out += c;
+            }
+        }
+
+        /// Appends the quoted name of a type, its identifier in hex in case it has no name.
+        inline void AppendTypeLabel(std::string& out, TypeId typeId, std::string_view name) {
+            out += '"';
+            if (name.empty()) {
+                char hex[2 + RTTI_TYPEID_BITS / 4 + 1];
+                std::snprintf(hex, sizeof(hex), "0x%0*llx", RTTI_TYPEID_BITS / 4,
+                              static_cast<unsigned long long>(typeId));
+                out += hex;
+            }
+            AppendEscaped(out, name);
+            out += '"';
+        }
+    }  // namespace Detail
+}  // namespace RTTI
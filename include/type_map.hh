@@ -0,0 +1,289 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtti.hh"
+#include "type_memo.hh"
+
+namespace RTTI {
+    /**
+     * Map from RTTI enabled types to values, which also finds the value of the most derived
+     * ancestor of an object that has a value. The ancestor found for each dynamic type is
+     * memoized, such that repeated lookups for objects of the same type cost a single probe
+     * of an open addressing table.
+     *
+     * Values are inserted but never replaced or removed. Lookups never take a lock nor wait
+     * for inserts running concurrently. Inserts invalidate the memoized ancestors in place.
+     * Tables replaced by growing are kept until the map is destroyed, which at most doubles
+     * the memory of the tables.
+     * @tparam V The type of the values.
+     */
+    template <typename V>
+    class TypeMap {
+        struct Entry {
+            TypeId id;
+
+            /// Depth of the type and the order of insertion, ranking ancestors.
+            std::size_t depth;
+            std::size_t order;
+
+            V value;
+        };
+
+        struct KeySlot {
+            std::atomic<Entry const*> entry{nullptr};
+        };
+
+        using KeyTable = Detail::AtomicTable<KeySlot>;
+
+        /// Memoized result of a dynamic type without an ancestor that has a value.
+        static constexpr std::uintptr_t None = 1;
+        static constexpr std::size_t InitialCapacity = 16;
+
+    public:
+        TypeMap()
+            : _keys(new KeyTable(InitialCapacity))
+            , _memo(InitialCapacity) {}
+
+        TypeMap(TypeMap const&) = delete;
+        TypeMap& operator=(TypeMap const&) = delete;
+
+        ~TypeMap() {
+            Free(_retiredKeys);
+            delete _keys.load();
+        }
+
+        /**
+         * Inserts a value for the type T constructed from the arguments, unless the type
+         * already has a value.
+         * @tparam T The type, which has to declare its type information.
+         * @returns False in case the type already has a value.
+         */
+        template <typename T, typename... Args>
+        bool emplace(Args&&... args) {
+            static_assert(std::is_base_of_v<Enable, T>, "Keys have to be RTTI enabled types.");
+
+            std::lock_guard<std::mutex> lock(_writer);
+            if (findEntry(TypeInfo<T>::Id()) != nullptr) {
+                return false;
+            }
+            _entries.push_back(std::unique_ptr<Entry const>(
+                new Entry{TypeInfo<T>::Id(), T::TypeInfo::Depth(), _entries.size(),
+                          V(std::forward<Args>(args)...)}));
+            auto const* entry = _entries.back().get();
+
+            auto* keys = _keys.load(std::memory_order_relaxed);
+            if (_entries.size() * 2 > keys->capacity()) {
+                auto* grown = new KeyTable(keys->capacity() * 2);
+                for (auto const& existing : _entries) {
+                    Place(*grown, existing.get());
+                }
+                _keys.store(grown, std::memory_order_release);
+                keys->next = std::exchange(_retiredKeys, keys);
+            } else {
+                Place(*keys, entry);
+            }
+            _size.store(_entries.size(), std::memory_order_release);
+
+            // The new value may be nearer than the memoized ancestors, including those being
+            // resolved right now
+            _memo.clear();
+            return true;
+        }
+
+        /// Inserts the passed value for the type T, unless the type already has a value.
+        template <typename T>
+        bool insert(V value) {
+            return emplace<T>(std::move(value));
+        }
+
+        /**
+         * Returns the value of the type identified by the passed type id.
+         * @returns Pointer to the value, nullptr if the type has no value.
+         */
+        [[nodiscard]] V const* find(TypeId typeId) const noexcept {
+            auto const* entry = findEntry(typeId);
+            return entry != nullptr ? &entry->value : nullptr;
+        }
+
+        template <typename T>
+        [[nodiscard]] V const* find() const noexcept {
+            return find(TypeInfo<T>::Id());
+        }
+
+        /**
+         * Returns the value of the most derived ancestor of the object that has a value,
+         * the object's own type included. Of unrelated ancestors, such as the parents of a
+         * type with multiple parents, the deeper one wins, then the one inserted first.
+         * @param object Pointer to the object, may be a nullptr.
+         * @returns Pointer to the value, nullptr if no ancestor has a value.
+         */
+        [[nodiscard]] V const* find_nearest(Enable const* object) const noexcept {
+            if (object == nullptr) {
+                return nullptr;
+            }
+            auto const typeId = object->typeId();
+            auto const found = _memo.find(typeId);
+            if (found.value != 0) {
+                return Decode(found.value);
+            }
+
+            auto const result = resolve(*object);
+            _memo.insert(found, typeId, result);
+            return Decode(result);
+        }
+
+        /// Returns the number of types with a value.
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _size.load(std::memory_order_acquire);
+        }
+
+    private:
+        static void Free(KeyTable* table) noexcept {
+            while (table != nullptr) {
+                delete std::exchange(table, table->next);
+            }
+        }
+
+        static void Place(KeyTable& keys, Entry const* entry) noexcept {
+            auto slot = keys.slotOf(entry->id);
+            while (keys.slots[slot].entry.load(std::memory_order_relaxed) != nullptr) {
+                slot = (slot + 1) & keys.mask;
+            }
+            keys.slots[slot].entry.store(entry, std::memory_order_release);
+        }
+
+        static V const* Decode(std::uintptr_t result) noexcept {
+            return result != None ? &reinterpret_cast<Entry const*>(result)->value : nullptr;
+        }
+
+        [[nodiscard]] Entry const* findEntry(TypeId typeId) const noexcept {
+            auto const* keys = _keys.load(std::memory_order_acquire);
+            for (auto slot = keys->slotOf(typeId);; slot = (slot + 1) & keys->mask) {
+                auto const* entry = keys->slots[slot].entry.load(std::memory_order_acquire);
+                if (entry == nullptr || entry->id == typeId) {
+                    return entry;
+                }
+            }
+        }
+
+        /// Finds the most derived ancestor of the object that has a value.
+        [[nodiscard]] std::uintptr_t resolve(Enable const& object) const noexcept {
+            auto const* keys = _keys.load(std::memory_order_acquire);
+            Entry const* nearest = nullptr;
+            for (std::size_t i = 0; i < keys->capacity(); ++i) {
+                auto const* entry = keys->slots[i].entry.load(std::memory_order_acquire);
+                if (entry == nullptr || !object.isById(entry->id)) {
+                    continue;
+                }
+                if (nearest == nullptr || entry->depth > nearest->depth ||
+                    (entry->depth == nearest->depth && entry->order < nearest->order)) {
+                    nearest = entry;
+                }
+            }
+            return nearest != nullptr ? reinterpret_cast<std::uintptr_t>(nearest) : None;
+        }
+
+        std::atomic<KeyTable*> _keys;
+        mutable Detail::TypeMemo _memo;
+        KeyTable* _retiredKeys = nullptr;
+        std::atomic<std::size_t> _size{0};
+        std::vector<std::unique_ptr<Entry const>> _entries;
+        std::mutex _writer;
+    };
+
+    /**
+     * Immutable map from a fixed list of RTTI enabled types to values. The identifiers of
+     * the types are placed in a perfect hash table at compile-time, such that finding the
+     * value of a type costs a single probe. Nearest lookups probe the types from the most
+     * derived to the least derived, as ranked by TypeMap.
+     * @tparam V The type of the values.
+     * @tparam Types The types with a value, in the order of the values.
+     */
+    template <typename V, typename... Types>
+    class FrozenTypeMap {
+        static constexpr std::size_t Size = sizeof...(Types);
+
+        static_assert(Size > 0, "Frozen type maps hold at least one type.");
+        static_assert((... && std::is_base_of_v<Enable, Types>),
+                      "Keys have to be RTTI enabled types.");
+
+        static constexpr std::array<TypeId, Size> Ids = {TypeInfo<Types>::Id()...};
+
+        static_assert(Detail::AreUnique(Ids), "Type identifier collision between the keys.");
+
+        using Table = Detail::SlotTable<TypeInfo<Types>::Id()...>;
+
+        /// Indices of the types from the deepest to the shallowest, stable otherwise.
+        static constexpr std::array<std::size_t, Size> Order =
+            Detail::DescendingOrder(std::array<std::size_t, Size>{Types::TypeInfo::Depth()...});
+
+    public:
+        /// Constructs the map from the values of the types, in the order of the types.
+        template <typename... Args>
+        constexpr explicit FrozenTypeMap(Args&&... values)
+            : _values{{std::forward<Args>(values)...}} {
+            static_assert(sizeof...(Args) == Size, "Pass a single value per type.");
+        }
+
+        [[nodiscard]] static constexpr std::size_t size() noexcept {
+            return Size;
+        }
+
+        /**
+         * Returns the value of the type identified by the passed type id.
+         * @returns Pointer to the value, nullptr if the type has no value.
+         */
+        [[nodiscard]] constexpr V const* find(TypeId typeId) const noexcept {
+            if constexpr (Table::Hash.valid) {
+                auto const slot = Table::Hash(typeId);
+                return Table::SlotIds[slot] == typeId ? &_values[Table::SlotIndices[slot]]
+                                                      : nullptr;
+            } else {
+                for (std::size_t i = 0; i < Size; ++i) {
+                    if (Ids[i] == typeId) {
+                        return &_values[i];
+                    }
+                }
+                return nullptr;
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] constexpr V const* find() const noexcept {
+            return find(TypeInfo<T>::Id());
+        }
+
+        /**
+         * Returns the value of the most derived ancestor of the object that has a value,
+         * the object's own type included.
+         * @param object Pointer to the object, may be a nullptr.
+         * @returns Pointer to the value, nullptr if no ancestor has a value.
+         */
+        [[nodiscard]] V const* find_nearest(Enable const* object) const noexcept {
+            if (object == nullptr) {
+                return nullptr;
+            }
+            if (auto const* value = find(object->typeId())) {
+                return value;
+            }
+            for (auto const index : Order) {
+                if (object->isById(Ids[index])) {
+                    return &_values[index];
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        std::array<V, Size> _values;
+    };
+}  // namespace RTTI
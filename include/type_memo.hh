@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "rtti.hh"
+
+namespace RTTI {
+    namespace Detail {
+        /// Open addressing table keyed by type identifiers, holding atomic slots.
+        template <typename Slot>
+        struct AtomicTable {
+            explicit AtomicTable(std::size_t capacity)
+                : mask(capacity - 1)
+                , slots(new Slot[capacity]) {}
+
+            [[nodiscard]] std::size_t capacity() const noexcept {
+                return mask + 1;
+            }
+
+            [[nodiscard]] std::size_t slotOf(TypeId typeId) const noexcept {
+                auto const hash = static_cast<std::uint64_t>(typeId) * UINT64_C(0x9E3779B97F4A7C15);
+                return static_cast<std::size_t>(hash >> 32) & mask;
+            }
+
+            std::size_t const mask;
+            std::unique_ptr<Slot[]> const slots;
+
+            /// Number of claimed slots.
+            std::atomic<std::size_t> used{0};
+
+            /// Next table in the list of replaced tables.
+            AtomicTable* next = nullptr;
+        };
+
+        /**
+         * Lock-free memo of a non-zero value per dynamic type, such as a result computed
+         * from the first object of the type seen. Lookups and inserts never take a lock.
+         * The first value inserted for a type is kept, later ones are dropped. The table
+         * grows to twice its size when three quarters full, tables replaced by growing are
+         * kept until the memo is destroyed. Clearing advances the generation instead of
+         * replacing the table, values of older generations are ignored and overwritten.
+         */
+        class TypeMemo {
+            struct Slot {
+                std::atomic<TypeId> id{Empty};
+
+                /// Generation the value was inserted in, zero if none, Busy while written.
+                std::atomic<std::uint64_t> generation{0};
+
+                std::atomic<std::uintptr_t> value{0};
+            };
+
+            using Table = AtomicTable<Slot>;
+
+            static constexpr TypeId Empty = TypeInfo<void>::Id();
+            static constexpr std::uint64_t Busy = ~std::uint64_t(0);
+
+        public:
+            /// Result of a lookup along with the table and generation inserts go into.
+            struct Found {
+                std::uintptr_t value;
+                Table* table;
+                std::uint64_t generation;
+            };
+
+            explicit TypeMemo(std::size_t capacity = 16)
+                : _table(new Table(capacity)) {}
+
+            TypeMemo(TypeMemo const&) = delete;
+            TypeMemo& operator=(TypeMemo const&) = delete;
+
+            ~TypeMemo() {
+                Free(_retired.load());
+                delete _table.load();
+            }
+
+            /**
+             * Looks up the value of the passed dynamic type.
+             * @returns The value, zero in case none has been inserted yet.
+             */
+            [[nodiscard]] Found find(TypeId typeId) const noexcept {
+                auto const generation = _generation.load(std::memory_order_acquire);
+                auto* table = _table.load(std::memory_order_acquire);
+                auto slot = table->slotOf(typeId);
+                for (std::size_t probe = 0; probe < table->capacity(); ++probe) {
+                    auto const& entry = table->slots[slot];
+                    auto const id = entry.id.load(std::memory_order_acquire);
+                    if (id == typeId) {
+                        if (entry.generation.load(std::memory_order_acquire) != generation) {
+                            break;
+                        }
+                        return {entry.value.load(std::memory_order_acquire), table, generation};
+                    }
+                    if (id == Empty) {
+                        break;
+                    }
+                    slot = (slot + 1) & table->mask;
+                }
+                return {0, table, generation};
+            }
+
+            /**
+             * Inserts the value of the passed dynamic type into the table probed by the
+             * lookup, in the generation of the lookup, such that values computed before the
+             * memo was cleared are ignored. Slots are claimed by the first thread inserting
+             * the type, others keep computing the value themselves until filled in.
+             */
+            void insert(Found const& found, TypeId typeId, std::uintptr_t value) noexcept {
+                auto* table = found.table;
+                if (table->used.load(std::memory_order_relaxed) * 4 < table->capacity() * 3) {
+                    Claim(*table, typeId, found.generation, value);
+                    return;
+                }
+
+                auto* grown = new (std::nothrow) Table(table->capacity() * 2);
+                if (grown == nullptr) {
+                    return;
+                }
+                for (std::size_t i = 0; i < table->capacity(); ++i) {
+                    auto const& entry = table->slots[i];
+                    auto const generation = entry.generation.load(std::memory_order_acquire);
+                    if (generation == found.generation) {
+                        Claim(*grown, entry.id.load(std::memory_order_relaxed), generation,
+                              entry.value.load(std::memory_order_acquire));
+                    }
+                }
+                Claim(*grown, typeId, found.generation, value);
+                if (_table.compare_exchange_strong(table, grown, std::memory_order_acq_rel)) {
+                    retire(table);
+                } else {
+                    delete grown;
+                }
+            }
+
+            /// Drops all values, including those being inserted right now.
+            void clear() noexcept {
+                _generation.fetch_add(1, std::memory_order_acq_rel);
+            }
+
+        private:
+            static void Free(Table* table) noexcept {
+                while (table != nullptr) {
+                    delete std::exchange(table, table->next);
+                }
+            }
+
+            static void Claim(Table& table, TypeId typeId, std::uint64_t generation,
+                              std::uintptr_t value) noexcept {
+                auto slot = table.slotOf(typeId);
+                for (std::size_t probe = 0; probe < table.capacity(); ++probe) {
+                    auto& entry = table.slots[slot];
+                    auto id = entry.id.load(std::memory_order_relaxed);
+                    if (id == Empty && entry.id.compare_exchange_strong(
+                                           id, typeId, std::memory_order_relaxed)) {
+                        table.used.fetch_add(1, std::memory_order_relaxed);
+                        Fill(entry, generation, value);
+                        return;
+                    }
+                    if (id == typeId) {
+                        Fill(entry, generation, value);
+                        return;
+                    }
+                    slot = (slot + 1) & table.mask;
+                }
+            }
+
+            /**
+             * Writes the value of the passed generation into the slot, unless the slot holds
+             * a value of the same or a later generation or is being written. Generations of
+             * a slot only increase, so readers never see a value of another generation.
+             */
+            static void Fill(Slot& entry, std::uint64_t generation, std::uintptr_t value) noexcept {
+                auto current = entry.generation.load(std::memory_order_relaxed);
+                while (current < generation) {
+                    if (entry.generation.compare_exchange_weak(current, Busy,
+                                                               std::memory_order_acquire,
+                                                               std::memory_order_relaxed)) {
+                        entry.value.store(value, std::memory_order_release);
+                        entry.generation.store(generation, std::memory_order_release);
+                        return;
+                    }
+                }
+            }
+
+            void retire(Table* table) noexcept {
+                table->next = _retired.load(std::memory_order_relaxed);
+                while (!_retired.compare_exchange_weak(table->next, table,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed)) {
+                }
+            }
+
+            std::atomic<Table*> _table;
+            std::atomic<Table*> _retired{nullptr};
+            std::atomic<std::uint64_t> _generation{1};
+        };
+    }  // namespace Detail
+}  // namespace RTTI
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "id_slot.hh"
+#include "rtti.hh"
+
+namespace RTTI {
+    /**
+     * Declares the complete set of types of a sealed hierarchy with the passed base. Can be
+     * specialized using RTTI_DECLARE_SEALED, in which case RTTI::visit on objects of the
+     * base type dispatches through a dense table covering every type of the hierarchy.
+     * @tparam Base The base type of the hierarchy.
+     */
+    template <typename Base>
+    struct Sealed;
+
+    namespace Detail {
+        /// Deduces the result and parameter type of a single parameter handler.
+        template <typename F>
+        struct HandlerTraits : HandlerTraits<decltype(&F::operator())> {};
+
+        template <typename R, typename A>
+        struct HandlerTraits<R (*)(A)> {
+            using Result = R;
+            using Arg = A;
+        };
+
+        template <typename R, typename A>
+        struct HandlerTraits<R (*)(A) noexcept> : HandlerTraits<R (*)(A)> {};
+
+        template <typename C, typename R, typename A>
+        struct HandlerTraits<R (C::*)(A)> : HandlerTraits<R (*)(A)> {};
+
+        template <typename C, typename R, typename A>
+        struct HandlerTraits<R (C::*)(A) const> : HandlerTraits<R (*)(A)> {};
+
+        template <typename C, typename R, typename A>
+        struct HandlerTraits<R (C::*)(A) noexcept> : HandlerTraits<R (*)(A)> {};
+
+        template <typename C, typename R, typename A>
+        struct HandlerTraits<R (C::*)(A) const noexcept> : HandlerTraits<R (*)(A)> {};
+
+        /// The type handled by the handler F, stripped of references and qualifiers.
+        template <typename F>
+        using HandledType = std::remove_cv_t<
+            std::remove_reference_t<typename HandlerTraits<std::decay_t<F>>::Arg>>;
+
+        template <typename F>
+        using HandlerResult = typename HandlerTraits<std::decay_t<F>>::Result;
+
+        /// Checks whether the sealed hierarchy of the type T has been declared.
+        template <typename T, typename = void>
+        struct IsSealed : std::false_type {};
+
+        template <typename T>
+        struct IsSealed<T, std::void_t<typename Sealed<T>::Types>> : std::true_type {};
+
+        /// Counts the types in Ps which are a strict base of the type P.
+        template <typename P, typename... Ps>
+        constexpr std::size_t BaseCount() noexcept {
+            return (std::size_t{0} + ... +
+                    (std::is_base_of_v<Ps, P> && !std::is_same_v<Ps, P> ? 1 : 0));
+        }
+
+        /**
+         * Orders the handled types such that derived types precede their bases. Types
+         * are sorted by the number of other handled types they derive from, which is
+         * strictly larger for a derived type than for any of its bases.
+         */
+        template <typename... Ps>
+        constexpr std::array<std::size_t, sizeof...(Ps)> MostDerivedFirst() noexcept {
+            return DescendingOrder(
+                std::array<std::size_t, sizeof...(Ps)>{BaseCount<Ps, Ps...>()...});
+        }
+
+        /**
+         * Returns the index of the most derived handled type which is the same as or a
+         * base of the type D, sizeof...(Ps) if none.
+         */
+        template <typename D, typename... Ps>
+        constexpr std::size_t BestHandler() noexcept {
+            constexpr std::array<bool, sizeof...(Ps)> matches = {std::is_base_of_v<Ps, D>...};
+            for (auto const index : MostDerivedFirst<Ps...>()) {
+                if (matches[index]) {
+                    return index;
+                }
+            }
+            return sizeof...(Ps);
+        }
+
+        /**
+         * Compile-time generated dispatch tables for visiting objects of the static type U
+         * using handlers of the types Fs.
+         */
+        template <typename U, typename... Fs>
+        struct Visitor {
+            static constexpr std::size_t Size = sizeof...(Fs);
+
+            static_assert((... && !std::is_reference_v<HandlerResult<Fs>>),
+                          "Handlers have to return by value, return a pointer instead of a "
+                          "reference.");
+
+            using Result = std::common_type_t<HandlerResult<Fs>...>;
+            static_assert(std::is_void_v<Result> || std::is_default_constructible_v<Result>,
+                          "The result of the handlers has to be default constructible, as it "
+                          "is value initialized in case no handler matches.");
+
+            using Handlers = std::tuple<Fs&...>;
+            using Thunk = Result (*)(U*, Handlers&);
+
+            template <std::size_t I>
+            using Handled = std::tuple_element_t<I, std::tuple<HandledType<Fs>...>>;
+
+            /**
+             * Invokes the handler I on the object, which is known to be an instance of D.
+             * Resolves the handled type using a static_cast from D where possible.
+             */
+            template <std::size_t I, typename D>
+            static Result Invoke(U* ptr, Handlers& handlers) {
+                using P = Handled<I>;
+                if constexpr (IsStaticCastable<U const, D const>::value) {
+                    using Derived = CastResult<D, U>;
+                    return std::get<I>(handlers)(*static_cast<CastResult<P, U>>(
+                        static_cast<Derived>(ptr)));
+                } else {
+                    return std::get<I>(handlers)(*LookupCast<P>(ptr));
+                }
+            }
+
+            template <std::size_t... Is>
+            static constexpr std::array<Thunk, Size> MakeThunks(std::index_sequence<Is...>) {
+                return {&Invoke<Is, Handled<Is>>...};
+            }
+
+            /// Thunks invoking each handler on an object of exactly the handled type.
+            static constexpr std::array<Thunk, Size> Thunks =
+                MakeThunks(std::index_sequence_for<Fs...>{});
+
+            /// Identifiers of the handled types, sorted in ascending order.
+            using Sorted = SortedIds<TypeInfo<HandledType<Fs>>::Id()...>;
+
+            /// Order in which handlers are tried when the dynamic type is not handled.
+            static constexpr std::array<std::size_t, Size> Fallback =
+                MostDerivedFirst<HandledType<Fs>...>();
+
+            /// Number of entries in the direct mapped cache of base handlers.
+            static constexpr std::size_t CacheSize = 64;
+
+            /// Base handler of recently seen dynamic types, stored as the index plus one.
+            static inline std::array<IdSlot<>, CacheSize> cache{};
+
+            /// Finds the handler of the most derived handled base of the object, Size if none.
+            template <std::size_t... Is>
+            [[nodiscard]] static std::size_t FindBase(U* ptr, std::index_sequence<Is...>) noexcept {
+                constexpr std::array<bool (*)(U const*), Size> checks = {
+                    &RTTI::is<Handled<Is>, U>...};
+                for (auto const index : Fallback) {
+                    if (checks[index](ptr)) {
+                        return index;
+                    }
+                }
+                return Size;
+            }
+
+            template <std::size_t I>
+            static Result LookupInvoke(U* ptr, Handlers& handlers) {
+                return std::get<I>(handlers)(*LookupCast<Handled<I>>(ptr));
+            }
+
+            template <std::size_t... Is>
+            static constexpr std::array<Thunk, Size> MakeLookups(std::index_sequence<Is...>) {
+                return {&LookupInvoke<Is>...};
+            }
+
+            /// Thunks invoking each handler on an object of a type derived from the handled type.
+            static constexpr std::array<Thunk, Size> Lookups =
+                MakeLookups(std::index_sequence_for<Fs...>{});
+
+            /**
+             * Dispatches the object through the sorted table of handled types. The base
+             * handler of dynamic types without a handler of their own is memoized per
+             * dynamic type.
+             */
+            static Result Dispatch(U* ptr, Handlers& handlers) {
+                auto const typeId = ptr->typeId();
+                auto index = Sorted::Find(typeId);
+                if (index != Size) {
+                    return Thunks[index](ptr, handlers);
+                }
+
+                auto& entry = cache[typeId % CacheSize];
+                std::uint32_t cached;
+                if (entry.load(typeId, cached)) {
+                    index = static_cast<std::size_t>(cached) - 1;
+                } else {
+                    index = FindBase(ptr, std::index_sequence_for<Fs...>{});
+                    entry.store(typeId, static_cast<std::uint32_t>(index + 1));
+                }
+                return index != Size ? Lookups[index](ptr, handlers) : Result();
+            }
+        };
+
+        /**
+         * Dense dispatch table for visiting objects of a sealed hierarchy. The handler of
+         * every type in the hierarchy, including the most derived base handler of types
+         * without a handler of their own, is resolved at compile-time and stored in a
+         * perfect hash table keyed on the type identifiers.
+         */
+        template <typename U, typename List, typename... Fs>
+        struct SealedVisitor;
+
+        template <typename U, typename... Ds, typename... Fs>
+        struct SealedVisitor<U, TypeList<Ds...>, Fs...> {
+            using Generic = Visitor<U, Fs...>;
+            using Result = typename Generic::Result;
+            using Handlers = typename Generic::Handlers;
+            using Thunk = typename Generic::Thunk;
+
+            static constexpr std::size_t Size = sizeof...(Ds);
+
+            static constexpr std::array<TypeId, Size> Ids = {TypeInfo<Ds>::Id()...};
+
+            static_assert(AreUnique(Ids), "Type identifier collision within the hierarchy.");
+
+            using Table = SlotTable<TypeInfo<Ds>::Id()...>;
+
+            template <typename D>
+            static constexpr Thunk HandlerOf() noexcept {
+                constexpr auto index = BestHandler<D, HandledType<Fs>...>();
+                if constexpr (index == sizeof...(Fs)) {
+                    return &Unhandled;
+                } else {
+                    return &Generic::template Invoke<index, D>;
+                }
+            }
+
+            static Result Unhandled(U*, Handlers&) {
+                return Result();
+            }
+
+            /// Thunk stored in each slot, unused slots hold the unhandled thunk.
+            static constexpr std::array<Thunk, Table::Slots> SlotThunks = [] {
+                std::array<Thunk, Table::Slots> slotThunks{};
+                constexpr std::array<Thunk, Size> thunks = {HandlerOf<Ds>()...};
+                for (auto& slotThunk : slotThunks) {
+                    slotThunk = &Unhandled;
+                }
+                for (std::size_t i = 0; i < Size; ++i) {
+                    slotThunks[Table::Hash(Ids[i])] = thunks[i];
+                }
+                return slotThunks;
+            }();
+
+            /// Dispatches the object through the dense table of the sealed hierarchy.
+            static Result Dispatch(U* ptr, Handlers& handlers) {
+                static_assert(Table::Hash.valid,
+                              "Unable to generate a dense table for the hierarchy.");
+
+                auto const typeId = ptr->typeId();
+                auto const slot = Table::Hash(typeId);
+                if (Table::SlotIds[slot] == typeId) {
+                    return SlotThunks[slot](ptr, handlers);
+                }
+                return Generic::Dispatch(ptr, handlers);
+            }
+        };
+    }  // namespace Detail
+
+    /**
+     * Invokes the handler matching the dynamic type of the passed object. Handlers are
+     * callables taking a single reference to a type in the hierarchy of the object and
+     * returning a default constructible value of a common type, or void. References can
+     * not be returned, as objects without a handler yield a value initialized result. The
+     * handler of exactly the dynamic type is found using a single lookup in a table of
+     * type identifiers generated at compile-time. In case the dynamic type has no handler
+     * of its own the handler of its most derived handled base is invoked, which is
+     * memoized per dynamic type. For sealed hierarchies, declared using
+     * RTTI_DECLARE_SEALED, the handler of each type in the hierarchy is resolved at
+     * compile-time instead.
+     *
+     * @param obj The object to visit.
+     * @param handlers The handlers to choose from.
+     * @returns The result of the invoked handler, a value initialized result in case no
+     * handler matched.
+     */
+    template <typename U, typename... Fs>
+    decltype(auto) visit(U& obj, Fs&&... handlers) {
+        static_assert(sizeof...(Fs) > 0, "At least one handler is required.");
+
+        using Base = std::remove_const_t<U>;
+        std::tuple<Fs&...> refs(handlers...);
+        if constexpr (Detail::IsSealed<Base>::value) {
+            return Detail::SealedVisitor<U, typename Sealed<Base>::Types, Fs...>::Dispatch(&obj,
+                                                                                          refs);
+        } else {
+            return Detail::Visitor<U, Fs...>::Dispatch(&obj, refs);
+        }
+    }
+
+    /**
+     * Invokes the handler matching the dynamic type of the passed object, see above.
+     * @param ptr Pointer to the object to visit, may be a nullptr.
+     * @param handlers The handlers to choose from.
+     * @returns The result of the invoked handler, a value initialized result in case no
+     * handler matched or the passed pointer is a nullptr.
+     */
+    template <typename U, typename... Fs>
+    decltype(auto) visit(U* ptr, Fs&&... handlers) {
+        using Result = typename Detail::Visitor<U, Fs...>::Result;
+        if (ptr == nullptr) {
+            return Result();
+        }
+        return visit(*ptr, std::forward<Fs>(handlers)...);
+    }
+}  // namespace RTTI
+
+/**
+ * Declares the complete set of types in the sealed hierarchy with the passed base. To be
+ * used at global namespace scope after all types have been declared.
+ * @param Base The base type of the hierarchy.
+ * @param Derived Variadic number of types derived from the base.
+ */
+#define RTTI_DECLARE_SEALED(Base, ...)                                  \
+    template <>                                                         \
+    struct RTTI::Sealed<Base> {                                         \
+        using Types = RTTI::Detail::TypeList<Base, ##__VA_ARGS__>;      \
+    }
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <analysis.hh>
+#include <string>
+
+namespace {
+    struct Animal : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Animal);
+    };
+
+    struct Pet : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Pet);
+    };
+
+    struct Dog
+        : Animal
+        , Pet {
+        RTTI_DECLARE_TYPEINFO(Dog, Animal, Pet);
+    };
+
+    struct Puppy : Dog {
+        RTTI_DECLARE_TYPEINFO(Puppy, Dog);
+    };
+
+    struct Apex : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Apex);
+    };
+
+    struct Left : virtual Apex {
+        RTTI_DECLARE_TYPEINFO(Left, Apex);
+    };
+
+    struct Right : virtual Apex {
+        RTTI_DECLARE_TYPEINFO(Right, Apex);
+    };
+
+    struct Bottom
+        : Left
+        , Right {
+        RTTI_DECLARE_TYPEINFO(Bottom, Left, Right);
+    };
+
+    RTTI_REGISTER(Puppy);
+    RTTI_REGISTER(Bottom);
+
+    RTTI_MAX_CAST_COST(Puppy, 1);
+    RTTI_MAX_CAST_COST(Bottom, 1);
+
+    TEST(AnalysisTest, TypeInfo) {
+        static_assert(Animal::TypeInfo::Depth() == 0);
+        static_assert(Dog::TypeInfo::Depth() == 1);
+        static_assert(Puppy::TypeInfo::Depth() == 2);
+        static_assert(Bottom::TypeInfo::Depth() == 2);
+
+        static_assert(Puppy::TypeInfo::AncestorIds().size() == 4);
+        static_assert(Puppy::TypeInfo::AncestorIds()[0] == Puppy::TypeInfo::Id());
+        static_assert(Puppy::TypeInfo::Paths() == 4);
+
+        // The apex is reachable through both sides of the diamond
+        static_assert(Bottom::TypeInfo::AncestorIds().size() == 4);
+        static_assert(Bottom::TypeInfo::Paths() == 5);
+
+        static_assert(Bottom::TypeInfo::NodesVisitedWorstCase() ==
+                      (Bottom::TypeInfo::Descriptor().hash.valid ? 1 : 4));
+        EXPECT_GE(Puppy::TypeInfo::NodesVisitedWorstCase(), 1u);
+    }
+
+    TEST(AnalysisTest, Hierarchy) {
+        // Holds the types registered by other tests as well
+        auto const hierarchy = RTTI::Analysis::Hierarchy::Registered();
+        EXPECT_NE(hierarchy.find(Puppy::TypeInfo::Id()), nullptr);
+        EXPECT_NE(hierarchy.find(Pet::TypeInfo::Id()), nullptr);
+
+        auto const* bottom = hierarchy.find(Bottom::TypeInfo::Id());
+        ASSERT_NE(bottom, nullptr);
+        EXPECT_EQ(bottom->name, Bottom::TypeInfo::Name());
+        ASSERT_EQ(bottom->parents.size(), 2u);
+        EXPECT_EQ(bottom->parents[0], Left::TypeInfo::Id());
+        EXPECT_EQ(bottom->parents[1], Right::TypeInfo::Id());
+        EXPECT_EQ(bottom->ancestors, 4u);
+        EXPECT_EQ(bottom->depth, Bottom::TypeInfo::Depth());
+        EXPECT_EQ(bottom->paths, Bottom::TypeInfo::Paths());
+        EXPECT_EQ(bottom->worstCase, Bottom::TypeInfo::NodesVisitedWorstCase());
+
+        auto const* animal = hierarchy.find(Animal::TypeInfo::Id());
+        ASSERT_NE(animal, nullptr);
+        EXPECT_TRUE(animal->parents.empty());
+        EXPECT_EQ(animal->depth, 0u);
+        EXPECT_EQ(hierarchy.find(RTTI::TypeInfo<int>::Id()), nullptr);
+
+        // Parents precede their children
+        auto const& nodes = hierarchy.nodes();
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            for (auto const parent : nodes[i].parents) {
+                EXPECT_LT(hierarchy.find(parent) - nodes.data(), static_cast<std::ptrdiff_t>(i));
+            }
+        }
+    }
+
+    TEST(AnalysisTest, Export) {
+        RTTI::Analysis::Hierarchy hierarchy;
+        auto const index = hierarchy.add(Dog::TypeInfo::Descriptor());
+        EXPECT_EQ(hierarchy.nodes().size(), 3u);
+        EXPECT_EQ(hierarchy.nodes()[index].id, Dog::TypeInfo::Id());
+
+        auto const dog = std::string(Dog::TypeInfo::Name());
+        auto const animal = std::string(Animal::TypeInfo::Name());
+
+        auto const dot = hierarchy.toDot();
+        EXPECT_EQ(dot.rfind("digraph rtti {", 0), 0u);
+        EXPECT_NE(dot.find("\"" + dog + "\" -> \"" + animal + "\";"), std::string::npos);
+        EXPECT_NE(dot.find("depth 1, ancestors 3, paths 3"), std::string::npos);
+
+        auto const json = hierarchy.toJson();
+        EXPECT_EQ(json.rfind("{\"types\":[", 0), 0u);
+        EXPECT_NE(json.find("{\"name\":\"" + dog + "\",\"parents\":[\"" + animal + "\","),
+                  std::string::npos);
+        EXPECT_NE(json.find("\"ancestors\":3,\"depth\":1,\"paths\":3"), std::string::npos);
+
+        // Indices of the nodes stay valid as further types are added
+        hierarchy.add<Puppy, Bottom>();
+        EXPECT_EQ(hierarchy.nodes()[index].id, Dog::TypeInfo::Id());
+    }
+}  // namespace
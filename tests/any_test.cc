@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <any.hh>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Shape : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Shape);
+
+    public:
+        virtual ~Shape() = default;
+    };
+
+    struct Named : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Named);
+
+    public:
+        std::string name = "label";
+    };
+
+    struct Label
+        : Shape
+        , Named {
+        RTTI_DECLARE_TYPEINFO(Label, Shape, Named);
+
+    public:
+        int size = 12;
+    };
+
+    struct Counted {
+        static inline int Instances = 0;
+
+        Counted() noexcept {
+            ++Instances;
+        }
+
+        Counted(Counted const&) noexcept {
+            ++Instances;
+        }
+
+        ~Counted() {
+            --Instances;
+        }
+    };
+
+    struct Large {
+        double values[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    };
+
+    struct Impostor {
+        float value = 1.5f;
+    };
+}  // namespace
+
+/// Gives Impostor the type identifier of int, as a colliding type name hash would.
+template <>
+struct RTTI::TypeInfo<Impostor> {
+    [[nodiscard]] static constexpr RTTI::TypeId Id() noexcept {
+        return TypeInfo<int>::Id();
+    }
+};
+
+TEST(Any, StoresSmallValuesInline) {
+    static_assert(RTTI::Any::StoresInline<int>);
+    static_assert(RTTI::Any::StoresInline<double>);
+    static_assert(RTTI::Any::StoresInline<std::unique_ptr<int>>);
+    static_assert(!RTTI::Any::StoresInline<Large>);
+    static_assert(std::is_copy_constructible_v<RTTI::Any>);
+    static_assert(!std::is_copy_constructible_v<RTTI::UniqueAny>);
+    static_assert(std::is_nothrow_move_constructible_v<RTTI::UniqueAny>);
+
+    RTTI::Any empty;
+    EXPECT_FALSE(empty.has_value());
+    EXPECT_TRUE(empty.is<void>());
+    EXPECT_EQ(RTTI::any_cast<int>(&empty), nullptr);
+
+    RTTI::Any value = 42;
+    ASSERT_TRUE(value.has_value());
+    EXPECT_TRUE(value.is<int>());
+    EXPECT_EQ(value.typeId(), RTTI::TypeInfo<int>::Id());
+    EXPECT_EQ(*RTTI::any_cast<int>(&value), 42);
+    EXPECT_EQ(RTTI::any_cast<long>(&value), nullptr);
+    EXPECT_EQ(RTTI::any_cast<int>(static_cast<RTTI::Any*>(nullptr)), nullptr);
+
+    value = 1.5;
+    EXPECT_EQ(*value.get<double>(), 1.5);
+    value = Large{};
+    EXPECT_EQ(value.get<Large>()->values[7], 8);
+    value.reset();
+    EXPECT_FALSE(value.has_value());
+}
+
+TEST(Any, CopiesAndMovesValues) {
+    {
+        RTTI::Any small = Counted{};
+        RTTI::Any large = std::vector<int>{1, 2, 3};
+        EXPECT_EQ(Counted::Instances, 1);
+
+        auto copy = small;
+        EXPECT_EQ(Counted::Instances, 2);
+        auto moved = std::move(copy);
+        EXPECT_EQ(Counted::Instances, 2);
+        EXPECT_FALSE(copy.has_value());
+
+        RTTI::Any vector = large;
+        vector.get<std::vector<int>>()->push_back(4);
+        EXPECT_EQ(large.get<std::vector<int>>()->size(), 3u);
+        EXPECT_EQ(vector.get<std::vector<int>>()->size(), 4u);
+
+        vector.swap(moved);
+        EXPECT_TRUE(vector.is<Counted>());
+        EXPECT_TRUE(moved.is<std::vector<int>>());
+        vector = moved;
+        EXPECT_EQ(Counted::Instances, 1);
+        EXPECT_EQ(vector.get<std::vector<int>>()->size(), 4u);
+    }
+    EXPECT_EQ(Counted::Instances, 0);
+}
+
+TEST(Any, HoldsMoveOnlyValues) {
+    RTTI::UniqueAny any = std::make_unique<int>(7);
+    EXPECT_EQ(**any.get<std::unique_ptr<int>>(), 7);
+
+    std::vector<RTTI::UniqueAny> values;
+    values.emplace_back(std::move(any));
+    values.emplace_back(std::in_place_type<std::string>, 3, 'x');
+    values.emplace_back().emplace<std::unique_ptr<int>>(new int(9));
+    EXPECT_FALSE(any.has_value());
+    EXPECT_EQ(**values[0].get<std::unique_ptr<int>>(), 7);
+    EXPECT_EQ(*values[1].get<std::string>(), "xxx");
+    EXPECT_EQ(**values[2].get<std::unique_ptr<int>>(), 9);
+}
+
+TEST(Any, CastsToAncestors) {
+    RTTI::Any any = Label{};
+    EXPECT_TRUE(any.is<Label>());
+    EXPECT_FALSE(any.is<Shape>());
+
+    auto const& constAny = any;
+    ASSERT_NE(RTTI::any_cast<Named>(&constAny), nullptr);
+    EXPECT_EQ(RTTI::any_cast<Named>(&constAny)->name, "label");
+    auto* shape = RTTI::any_cast<Shape>(&any);
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->cast<Label>()->size, 12);
+    EXPECT_EQ(static_cast<void*>(shape), static_cast<Shape*>(any.get<Label>()));
+    EXPECT_EQ(RTTI::any_cast<Counted>(&any), nullptr);
+
+    any = std::string("text");
+    EXPECT_EQ(RTTI::any_cast<Shape>(&any), nullptr);
+}
+
+TEST(Any, CollidingIdentifiersDoNotMatch) {
+    RTTI::Any any = Impostor{};
+    EXPECT_EQ(any.typeId(), RTTI::TypeInfo<int>::Id());
+    EXPECT_FALSE(any.is<int>());
+    EXPECT_TRUE(any.is<Impostor>());
+    EXPECT_EQ(any.get<int>(), nullptr);
+    ASSERT_NE(any.get<Impostor>(), nullptr);
+    EXPECT_EQ(any.get<Impostor>()->value, 1.5f);
+
+    any = Large{};
+    any = 3;
+    EXPECT_FALSE(any.is<Impostor>());
+    EXPECT_EQ(any.get<Impostor>(), nullptr);
+    EXPECT_EQ(*any.get<int>(), 3);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <batch.hh>
+#include <memory>
+#include <vector>
+
+namespace {
+    struct Base : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Base);
+    };
+
+    struct Interface : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Interface);
+    };
+
+    template <int N>
+    struct Derived : Base {
+        RTTI_DECLARE_TYPEINFO(Derived<N>, Base);
+    };
+
+    struct Mixed
+        : Derived<1>
+        , Interface {
+        RTTI_DECLARE_TYPEINFO(Mixed, Derived<1>, Interface);
+    };
+
+    struct Leaf final : Derived<2> {
+        RTTI_DECLARE_TYPEINFO(Leaf, Derived<2>);
+    };
+
+    /// Creates objects of several dynamic types, more than fit a single block.
+    std::vector<std::unique_ptr<Base>> MakeObjects(std::size_t count) {
+        std::vector<std::unique_ptr<Base>> objects;
+        for (std::size_t i = 0; i < count; ++i) {
+            switch ((i * 7) % 5) {
+                case 0: objects.emplace_back(std::make_unique<Derived<0>>()); break;
+                case 1: objects.emplace_back(std::make_unique<Derived<1>>()); break;
+                case 2: objects.emplace_back(std::make_unique<Derived<2>>()); break;
+                case 3: objects.emplace_back(std::make_unique<Mixed>()); break;
+                default: objects.emplace_back(std::make_unique<Leaf>()); break;
+            }
+        }
+        return objects;
+    }
+
+    std::vector<Base*> Pointers(std::vector<std::unique_ptr<Base>> const& objects) {
+        std::vector<Base*> pointers;
+        for (auto const& object : objects) {
+            pointers.push_back(object.get());
+        }
+        return pointers;
+    }
+
+    template <typename T>
+    std::size_t CountScalar(std::vector<Base*> const& objects) {
+        std::size_t count = 0;
+        for (auto const* object : objects) {
+            count += object->is<T>() ? 1 : 0;
+        }
+        return count;
+    }
+
+    TEST(BatchTest, Classify) {
+        auto const objects = MakeObjects(1000);
+        auto const pointers = Pointers(objects);
+        std::vector<RTTI::TypeId> ids(pointers.size());
+
+        RTTI::classify(pointers, ids.data());
+        for (std::size_t i = 0; i < pointers.size(); ++i) {
+            EXPECT_EQ(ids[i], pointers[i]->typeId());
+        }
+    }
+
+    TEST(BatchTest, CountIs) {
+        for (std::size_t count : {0, 1, 7, 256, 1000}) {
+            auto const objects = MakeObjects(count);
+            auto const pointers = Pointers(objects);
+
+            EXPECT_EQ(RTTI::count_is<Base>(pointers), count);
+            EXPECT_EQ(RTTI::count_is<Derived<1>>(pointers), CountScalar<Derived<1>>(pointers));
+            EXPECT_EQ(RTTI::count_is<Derived<2>>(pointers), CountScalar<Derived<2>>(pointers));
+            EXPECT_EQ(RTTI::count_is<Interface>(pointers), CountScalar<Interface>(pointers));
+            EXPECT_EQ(RTTI::count_is<Leaf>(pointers), CountScalar<Leaf>(pointers));
+            EXPECT_EQ(RTTI::count_is<Mixed>(pointers.data(), pointers.size()),
+                      CountScalar<Mixed>(pointers));
+        }
+    }
+
+    TEST(BatchTest, PartitionByType) {
+        auto const objects = MakeObjects(1000);
+        auto pointers = Pointers(objects);
+        auto const original = pointers;
+
+        auto const ends = RTTI::partition_by_type<Interface, Derived<2>>(pointers);
+        EXPECT_EQ(ends[0], CountScalar<Interface>(original));
+        EXPECT_EQ(ends[1], ends[0] + CountScalar<Derived<2>>(original));
+
+        for (std::size_t i = 0; i < pointers.size(); ++i) {
+            EXPECT_EQ(pointers[i]->is<Interface>(), i < ends[0]);
+            EXPECT_EQ(!pointers[i]->is<Interface>() && pointers[i]->is<Derived<2>>(),
+                      i >= ends[0] && i < ends[1]);
+        }
+
+        // The relative order within each group is preserved.
+        std::vector<Base*> expected;
+        for (auto* object : original) {
+            if (object->is<Interface>()) {
+                expected.push_back(object);
+            }
+        }
+        for (auto* object : original) {
+            if (!object->is<Interface>() && object->is<Derived<2>>()) {
+                expected.push_back(object);
+            }
+        }
+        for (auto* object : original) {
+            if (!object->is<Interface>() && !object->is<Derived<2>>()) {
+                expected.push_back(object);
+            }
+        }
+        EXPECT_EQ(pointers, expected);
+    }
+}  // namespace
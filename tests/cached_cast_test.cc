@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <cached_cast.hh>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    struct Base : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Base);
+    };
+
+    struct Interface : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Interface);
+    };
+
+    template <int N>
+    struct Derived
+        : Base
+        , Interface {
+        RTTI_DECLARE_TYPEINFO(Derived<N>, Base, Interface);
+        int value = N;
+    };
+
+    struct Other : Base {
+        RTTI_DECLARE_TYPEINFO(Other, Base);
+    };
+
+    Interface* CastToInterface(Base* base) {
+        return RTTI_CAST_CACHED(Interface, base);
+    }
+
+    /// Checks whether casting a Base into an Interface accepts the passed cache.
+    template <typename Cache, typename = void>
+    struct AcceptsCache : std::false_type {};
+
+    template <typename Cache>
+    struct AcceptsCache<Cache, std::void_t<decltype(RTTI::CachedCast<Interface>(
+                                   std::declval<Base*>(), std::declval<Cache&>()))>>
+        : std::true_type {};
+
+    static_assert(AcceptsCache<RTTI::CastCache<Interface, Base>>::value);
+    static_assert(!AcceptsCache<RTTI::CastCache<Base, Base>>::value);
+    static_assert(!AcceptsCache<RTTI::CastCache<Interface, Derived<0>>>::value);
+
+    TEST(CachedCastTest, HitsAndMisses) {
+        Derived<0> derived;
+        Other other;
+
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_EQ(CastToInterface(&derived), static_cast<Interface*>(&derived));
+            EXPECT_EQ(CastToInterface(&other), nullptr);
+            EXPECT_EQ(CastToInterface(nullptr), nullptr);
+        }
+    }
+
+    TEST(CachedCastTest, EntriesAreReplaced) {
+        RTTI::CastCache<Interface, Base, 2> cache;
+        Derived<1> d1;
+        Derived<2> d2;
+        Derived<3> d3;
+        std::vector<Base*> objects = {&d1, &d2, &d3, &d1, &d3, &d2};
+
+        for (auto* object : objects) {
+            EXPECT_EQ(RTTI::CachedCast<Interface>(object, cache), object->cast<Interface>());
+        }
+        for (auto const* object : objects) {
+            EXPECT_EQ(RTTI::CachedCast<Interface>(object, cache), object->cast<Interface>());
+        }
+    }
+
+    TEST(CachedCastTest, StaticUpcastsBypassTheCache) {
+        RTTI::CastCache<Interface, Derived<0>, 2> toInterface;
+        RTTI::CastCache<Base, Derived<0>, 2> toBase;
+        Derived<0> const derived;
+        Derived<0> const* object = &derived;
+
+        EXPECT_EQ(RTTI::CachedCast<Interface>(object, toInterface),
+                  static_cast<Interface const*>(&derived));
+        EXPECT_EQ(RTTI::CachedCast<Base>(object, toBase), static_cast<Base const*>(&derived));
+        EXPECT_EQ(toInterface.next.load(), 0u);
+        EXPECT_EQ(toBase.next.load(), 0u);
+    }
+
+    TEST(CachedCastTest, ConcurrentAccess) {
+        RTTI::CastCache<Interface, Base, 2> cache;
+        Derived<1> d1;
+        Derived<2> d2;
+        Derived<3> d3;
+        Other other;
+        std::vector<Base*> objects = {&d1, &d2, &d3, &other};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 10000; ++i) {
+                    auto* object = objects[(i + t) % objects.size()];
+                    EXPECT_EQ(RTTI::CachedCast<Interface>(object, cache),
+                              object->cast<Interface>());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}  // namespace
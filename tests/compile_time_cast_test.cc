@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <rtti.hh>
+#include <stats.hh>
+
+namespace {
+    struct Base : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Base);
+    };
+
+    struct Left : virtual Base {
+        RTTI_DECLARE_TYPEINFO(Left, Base);
+    };
+
+    struct Right : virtual Base {
+        RTTI_DECLARE_TYPEINFO(Right, Base);
+    };
+
+    struct Joined
+        : Left
+        , Right {
+        RTTI_DECLARE_TYPEINFO(Joined, Left, Right);
+    };
+
+    struct Sealed final : Left {
+        RTTI_DECLARE_TYPEINFO(Sealed, Left);
+    };
+
+    /// Returns the number of ancestor table lookups so far, dropped ones included.
+    std::uint64_t Lookups() {
+        auto const snapshot = RTTI::Stats::Collect();
+        auto lookups = snapshot.dropped;
+        for (auto const& entry : snapshot.entries) {
+            lookups += entry.hits + entry.misses;
+        }
+        return lookups;
+    }
+
+    TEST(CompileTimeCastTest, Upcasts) {
+        if (!RTTI::Stats::Enabled) {
+            GTEST_SKIP() << "Lookups are only counted with RTTI_ENABLE_STATS defined.";
+        }
+        Joined joined;
+        Joined* object = &joined;
+        Joined const* constObject = &joined;
+
+        // Resolving the ancestor table once counts as a lookup
+        EXPECT_EQ(RTTI::cast<Left>(static_cast<Base*>(object)), static_cast<Left*>(&joined));
+        auto const before = Lookups();
+        EXPECT_GT(before, 0u);
+
+        EXPECT_EQ(RTTI::cast<Base>(object), static_cast<Base*>(&joined));
+        EXPECT_EQ(object->cast<Right>(), static_cast<Right*>(&joined));
+        EXPECT_EQ(RTTI::cast<Base>(constObject), static_cast<Base const*>(&joined));
+        EXPECT_EQ(RTTI::cast<Right>(constObject), static_cast<Right const*>(&joined));
+        EXPECT_EQ(constObject->cast<Left>(), static_cast<Left const*>(&joined));
+        EXPECT_EQ(Lookups(), before);
+    }
+
+    TEST(CompileTimeCastTest, FinalDowncasts) {
+        if (!RTTI::Stats::Enabled) {
+            GTEST_SKIP() << "Lookups are only counted with RTTI_ENABLE_STATS defined.";
+        }
+        Sealed sealed;
+        Left left;
+        Left* object = &sealed;
+        Left const* constObject = &sealed;
+        Left const& constLeft = left;
+
+        // Final types are compared by their identifier only
+        auto const before = Lookups();
+        EXPECT_EQ(object->cast<Sealed>(), &sealed);
+        EXPECT_EQ(constObject->cast<Sealed>(), &sealed);
+        EXPECT_EQ(RTTI::cast<Sealed>(constObject), &sealed);
+        EXPECT_EQ(constLeft.cast<Sealed>(), nullptr);
+        EXPECT_EQ(Lookups(), before);
+    }
+}  // namespace
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <dispatch.hh>
+#include <string>
+
+namespace {
+    struct Body : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Body);
+    };
+
+    struct Sphere : Body {
+        RTTI_DECLARE_TYPEINFO(Sphere, Body);
+    };
+
+    struct Box : Body {
+        RTTI_DECLARE_TYPEINFO(Box, Body);
+    };
+
+    struct Cube : Box {
+        RTTI_DECLARE_TYPEINFO(Cube, Box);
+    };
+
+    struct Plane : Body {
+        RTTI_DECLARE_TYPEINFO(Plane, Body);
+    };
+
+    struct Hot : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Hot);
+    };
+
+    struct Fireball
+        : Sphere
+        , Hot {
+        RTTI_DECLARE_TYPEINFO(Fireball, Sphere, Hot);
+    };
+
+    std::string Collide(Body& a, Body& b) {
+        return RTTI::dispatch2(
+            a, b, [](Sphere&, Sphere&) { return std::string("sphere-sphere"); },
+            [](Sphere&, Box&) { return std::string("sphere-box"); },
+            [](Box&, Box&) { return std::string("box-box"); },
+            [](Body&, Plane&) { return std::string("body-plane"); });
+    }
+
+    TEST(DispatchTest, ExactPairs) {
+        Sphere sphere;
+        Box box;
+        EXPECT_EQ(Collide(sphere, sphere), "sphere-sphere");
+        EXPECT_EQ(Collide(sphere, box), "sphere-box");
+        EXPECT_EQ(Collide(box, box), "box-box");
+    }
+
+    TEST(DispatchTest, SymmetricHandlers) {
+        Sphere sphere;
+        Box box;
+        Plane plane;
+        EXPECT_EQ(Collide(box, sphere), "sphere-box");
+        EXPECT_EQ(Collide(plane, sphere), "body-plane");
+    }
+
+    TEST(DispatchTest, BaseHandlers) {
+        Sphere sphere;
+        Cube cube;
+        Plane plane;
+        EXPECT_EQ(Collide(cube, cube), "box-box");
+        EXPECT_EQ(Collide(cube, sphere), "sphere-box");
+        EXPECT_EQ(Collide(cube, plane), "body-plane");
+    }
+
+    TEST(DispatchTest, Unhandled) {
+        Body body;
+        Sphere sphere;
+        EXPECT_EQ(Collide(body, sphere), "");
+    }
+
+    TEST(DispatchTest, ObjectsArePassed) {
+        Sphere sphere;
+        Cube cube;
+        Body& a = cube;
+        Body& b = sphere;
+        RTTI::dispatch2(a, b, [&](Sphere& s, Box& x) {
+            EXPECT_EQ(&s, &sphere);
+            EXPECT_EQ(&x, static_cast<Box*>(&cube));
+        });
+    }
+
+    TEST(DispatchTest, UnrelatedHandledBases) {
+        Fireball fireball;
+        Sphere sphere;
+        Box box;
+        Plane plane;
+        Body& a = fireball;
+
+        auto const collide = [](Body& x, Body& y) {
+            return RTTI::dispatch2(
+                x, y, [](Sphere&, Sphere&) { return std::string("sphere-sphere"); },
+                [](Hot&, Box&) { return std::string("hot-box"); },
+                [](Body&, Plane&) { return std::string("body-plane"); });
+        };
+        for (int i = 0; i < 2; ++i) {
+            EXPECT_EQ(collide(a, sphere), "sphere-sphere");
+            EXPECT_EQ(collide(a, box), "hot-box");
+            EXPECT_EQ(collide(box, a), "hot-box");
+            EXPECT_EQ(collide(a, plane), "body-plane");
+            EXPECT_EQ(collide(a, a), "sphere-sphere");
+        }
+    }
+}  // namespace
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <event_bus.hh>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Event : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Event);
+    };
+
+    struct Tagged : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Tagged);
+
+    public:
+        std::string tag = "tagged";
+    };
+
+    struct KeyEvent : Event {
+        RTTI_DECLARE_TYPEINFO(KeyEvent, Event);
+
+    public:
+        int key = 0;
+    };
+
+    struct TaggedKeyEvent
+        : KeyEvent
+        , Tagged {
+        RTTI_DECLARE_TYPEINFO(TaggedKeyEvent, KeyEvent, Tagged);
+    };
+
+    struct MouseEvent : Event {
+        RTTI_DECLARE_TYPEINFO(MouseEvent, Event);
+    };
+
+    TEST(EventBus, DeliversEventsToSubscribersOfAncestors) {
+        RTTI::EventBus bus;
+        std::vector<std::string> received;
+        bus.subscribe<Event>([&](Event&) { received.push_back("event"); });
+        bus.subscribe<KeyEvent>(
+            [&](KeyEvent& e) { received.push_back("key" + std::to_string(e.key)); });
+        bus.subscribe<Tagged>([&](Tagged& e) { received.push_back(e.tag); });
+        EXPECT_EQ(bus.size(), 3u);
+
+        TaggedKeyEvent tagged;
+        tagged.key = 7;
+        EXPECT_EQ(bus.publish(tagged), 3u);
+        EXPECT_EQ(received, (std::vector<std::string>{"event", "key7", "tagged"}));
+
+        received.clear();
+        MouseEvent mouse;
+        EXPECT_EQ(bus.publish(mouse), 1u);
+        EXPECT_EQ(bus.publish(mouse), 1u);
+        EXPECT_EQ(received, (std::vector<std::string>{"event", "event"}));
+
+        received.clear();
+        Event& base = tagged;
+        EXPECT_EQ(bus.publish(base), 3u);
+        EXPECT_EQ(received, (std::vector<std::string>{"event", "key7", "tagged"}));
+    }
+
+    TEST(EventBus, UnsubscribeStopsDelivery) {
+        RTTI::EventBus bus;
+        int events = 0;
+        int keys = 0;
+        auto const id = bus.subscribe<Event>([&](Event&) { ++events; });
+        bus.subscribe<KeyEvent>([&](KeyEvent&) { ++keys; });
+
+        KeyEvent key;
+        bus.publish(key);
+        EXPECT_TRUE(bus.unsubscribe(id));
+        EXPECT_FALSE(bus.unsubscribe(id));
+        bus.publish(key);
+        EXPECT_EQ(events, 1);
+        EXPECT_EQ(keys, 2);
+
+        // Subscriptions may be changed from within a handler
+        RTTI::SubscriptionId self = 0;
+        self = bus.subscribe<Event>([&](Event&) {
+            bus.unsubscribe(self);
+            bus.subscribe<MouseEvent>([](MouseEvent&) {});
+        });
+        EXPECT_EQ(bus.publish(key), 2u);
+        EXPECT_EQ(bus.publish(key), 1u);
+        EXPECT_EQ(bus.size(), 2u);
+    }
+
+    TEST(EventBus, CarriesHandlersOverSubscriptionChanges) {
+        RTTI::EventBus bus;
+        std::vector<std::string> received;
+        auto const event = bus.subscribe<Event>([&](Event&) { received.push_back("event"); });
+        bus.subscribe<Tagged>([&](Tagged&) { received.push_back("tagged"); });
+
+        TaggedKeyEvent tagged;
+        MouseEvent mouse;
+        EXPECT_EQ(bus.publish(tagged), 2u);
+        EXPECT_EQ(bus.publish(mouse), 1u);
+
+        // Handlers of seen types are extended by new subscriptions, in order of subscription
+        bus.subscribe<KeyEvent>([&](KeyEvent&) { received.push_back("key"); });
+        received.clear();
+        EXPECT_EQ(bus.publish(tagged), 3u);
+        EXPECT_EQ(bus.publish(mouse), 1u);
+        EXPECT_EQ(received, (std::vector<std::string>{"event", "tagged", "key", "event"}));
+
+        EXPECT_TRUE(bus.unsubscribe(event));
+        received.clear();
+        EXPECT_EQ(bus.publish(tagged), 2u);
+        EXPECT_EQ(bus.publish(mouse), 0u);
+        EXPECT_EQ(received, (std::vector<std::string>{"tagged", "key"}));
+
+        bus.subscribe<Event>([&](Event&) { received.push_back("again"); });
+        received.clear();
+        EXPECT_EQ(bus.publish(tagged), 3u);
+        EXPECT_EQ(bus.publish(mouse), 1u);
+        EXPECT_EQ(received, (std::vector<std::string>{"tagged", "key", "again", "again"}));
+    }
+
+    TEST(EventBus, PublishersReclaimSnapshotsReplacedByHandlers) {
+        RTTI::EventBus bus;
+        auto const token = std::make_shared<int>(0);
+        RTTI::SubscriptionId self = 0;
+        self = bus.subscribe<Event>([&bus, &self, token](Event&) { bus.unsubscribe(self); });
+        EXPECT_EQ(token.use_count(), 2);
+
+        // The replaced snapshot holding the handler is freed once the publisher returns
+        MouseEvent mouse;
+        EXPECT_EQ(bus.publish(mouse), 1u);
+        EXPECT_EQ(bus.size(), 0u);
+        EXPECT_EQ(token.use_count(), 1);
+    }
+
+    TEST(EventBus, HandlersSubscribeWhileAnotherThreadSubscribes) {
+        RTTI::EventBus bus;
+        std::atomic<bool> entered{false};
+        std::atomic<bool> writing{false};
+        bus.subscribe<KeyEvent>([&](KeyEvent&) {
+            entered = true;
+            while (!writing.load()) {
+                std::this_thread::yield();
+            }
+            // Give the writer time to wait for this handler to finish
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            bus.subscribe<MouseEvent>([](MouseEvent&) {});
+        });
+
+        std::thread publisher([&] {
+            KeyEvent key;
+            EXPECT_EQ(bus.publish(key), 1u);
+        });
+        while (!entered.load()) {
+            std::this_thread::yield();
+        }
+        writing = true;
+        bus.subscribe<Tagged>([](Tagged&) {});
+        publisher.join();
+        EXPECT_EQ(bus.size(), 3u);
+    }
+
+    TEST(EventBus, PublishesConcurrentlyWithSubscriptionChanges) {
+        RTTI::EventBus bus;
+        std::atomic<std::size_t> delivered{0};
+        bus.subscribe<Event>([&](Event&) { delivered.fetch_add(1, std::memory_order_relaxed); });
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> publishers;
+        for (int t = 0; t < 4; ++t) {
+            publishers.emplace_back([&] {
+                TaggedKeyEvent tagged;
+                MouseEvent mouse;
+                while (!done.load()) {
+                    EXPECT_GE(bus.publish(tagged), 1u);
+                    EXPECT_GE(bus.publish(mouse), 1u);
+                }
+            });
+        }
+
+        while (delivered.load() == 0) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; i < 1000; ++i) {
+            auto const id = bus.subscribe<Tagged>([](Tagged& e) { EXPECT_EQ(e.tag, "tagged"); });
+            EXPECT_TRUE(bus.unsubscribe(id));
+        }
+        done = true;
+        for (auto& thread : publishers) {
+            thread.join();
+        }
+        EXPECT_EQ(bus.size(), 1u);
+    }
+}  // namespace
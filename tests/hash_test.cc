@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <rtti.hh>
+#include <string>
+
+namespace {
+    template <typename T>
+    struct Nest {};
+
+    template <std::size_t N>
+    struct Nested {
+        using type = Nest<typename Nested<N - 1>::type>;
+    };
+
+    template <>
+    struct Nested<0> {
+        using type = int;
+    };
+
+    /// The recursive FNV1a implementation the identifiers were originally based on.
+    constexpr std::uint32_t RecursiveFNV1a(const char* str, std::size_t n,
+                                           std::uint32_t hash = UINT32_C(2166136261)) {
+        return n == 0 ? hash
+                      : RecursiveFNV1a(str + 1, n - 1, (hash ^ str[0]) * UINT32_C(19777619));
+    }
+
+    constexpr std::string_view Spam = "Nobody inspects the spammish repetition";
+}  // namespace
+
+TEST(Hash, IterativeFNV1aMatchesRecursiveDefinition) {
+    static_assert(Hash::FNV1a("") == RecursiveFNV1a("", 0));
+    static_assert(Hash::FNV1a("RTTI::Enable") == RecursiveFNV1a("RTTI::Enable", 12));
+    EXPECT_EQ(Hash::FNV1a(Spam), RecursiveFNV1a(Spam.data(), Spam.size()));
+}
+
+TEST(Hash, MatchesReferenceVectors) {
+    static_assert(Hash::FNV1a64("") == UINT64_C(0xCBF29CE484222325));
+    static_assert(Hash::FNV1a64("a") == UINT64_C(0xAF63DC4C8601EC8C));
+    static_assert(Hash::XXH32("") == UINT32_C(0x02CC5D05));
+    static_assert(Hash::XXH32("abc") == UINT32_C(0x32D153FF));
+    static_assert(Hash::XXH32(Spam) == UINT32_C(0xE2293B2F));
+    static_assert(Hash::XXH64("") == UINT64_C(0xEF46DB3751D8E999));
+    static_assert(Hash::XXH64("abc") == UINT64_C(0x44BC2CF5AD770999));
+    static_assert(Hash::XXH64(Spam) == UINT64_C(0xFBCEA83C8A378BF1));
+}
+
+TEST(Hash, LongTypeNamesAreHashedAtCompileTime) {
+    using Long = Nested<48>::type;
+    static_assert(RTTI::TypeName<Long>().size() > 512);
+
+    constexpr auto id = RTTI::TypeInfo<Long>::Id();
+    EXPECT_EQ(id, RTTI::HashTypeName(RTTI::TypeName<Long>()));
+    EXPECT_NE(id, RTTI::TypeInfo<Nested<47>::type>::Id());
+}
+
+TEST(Hash, RuntimeTypeNamesMatchTypeIds) {
+    using Long = Nested<8>::type;
+    std::string const name(RTTI::TypeName<Long>());
+    EXPECT_EQ(RTTI::HashTypeName(name), RTTI::TypeInfo<Long>::Id());
+    EXPECT_EQ(RTTI::HashTypeName(RTTI::TypeName<int>()), RTTI::TypeInfo<int>::Id());
+    EXPECT_EQ(sizeof(RTTI::TypeId) * 8, std::size_t{RTTI_TYPEID_BITS});
+}
@@ -26,6 +26,10 @@ struct ChildB
     RTTI_DECLARE_TYPEINFO(ChildB, ParentA, ParentB);
 };
 
+struct ChildFinal final : ParentA {
+    RTTI_DECLARE_TYPEINFO(ChildFinal, ParentA);
+};
+
 template<typename T>
 struct ChildT
     : ParentA
@@ -94,6 +98,92 @@ namespace {
         EXPECT_TRUE(grandParent.is<GrandParent>());
     }
 
+    TEST(HierarchyTest, FlattenedAncestors) {
+        using Expected = RTTI::Detail::TypeList<ChildA, ParentA, GrandParent, ParentB>;
+        EXPECT_TRUE((std::is_same_v<ChildA::TypeInfo::Ancestors, Expected>));
+        EXPECT_EQ(ChildA::TypeInfo::AncestorTable::Size, 4u);
+
+        static_assert(ChildA::TypeInfo::Is(RTTI::TypeInfo<GrandParent>::Id()));
+        static_assert(!ParentA::TypeInfo::Is(RTTI::TypeInfo<ParentB>::Id()));
+        EXPECT_EQ(ChildA::TypeInfo::AncestorTable::Find(RTTI::TypeInfo<ChildB>::Id()),
+                  ChildA::TypeInfo::AncestorTable::Size);
+    }
+
+    TEST(HierarchyTest, DenseTypeIndices) {
+        auto const grandParent = RTTI::TypeInfo<GrandParent>::Index();
+        auto const parentA = RTTI::TypeInfo<ParentA>::Index();
+        auto const childA = ChildA::TypeInfo::Index();
+
+        EXPECT_EQ(RTTI::TypeInfo<ChildA const&>::Index(), childA);
+        EXPECT_NE(grandParent, parentA);
+        EXPECT_NE(parentA, childA);
+        EXPECT_LT(childA, RTTI::Detail::typeIndexCounter.load());
+
+        auto const& indices = ChildA::TypeInfo::AncestorTable::Indices();
+        EXPECT_TRUE(indices.contains(grandParent));
+        EXPECT_TRUE(indices.contains(parentA));
+        EXPECT_TRUE(indices.contains(childA));
+        EXPECT_FALSE(indices.contains(RTTI::TypeInfo<ChildB>::Index()));
+
+        ChildA object;
+        EXPECT_TRUE(object.isById(RTTI::TypeInfo<ParentB>::Id()));
+        EXPECT_FALSE(object.isById(RTTI::TypeInfo<ChildB>::Id()));
+    }
+
+    TEST(HierarchyTest, TypeDescriptor) {
+        auto const& descriptor = ChildA::TypeInfo::Descriptor();
+        EXPECT_EQ(descriptor.id, RTTI::TypeInfo<ChildA>::Id());
+        EXPECT_EQ(descriptor.name, RTTI::TypeInfo<ChildA>::Name());
+        EXPECT_EQ(descriptor.size, 4u);
+        EXPECT_NE(descriptor.find(RTTI::TypeInfo<ParentB>::Id()), descriptor.size);
+        EXPECT_EQ(descriptor.find(RTTI::TypeInfo<ChildB>::Id()), descriptor.size);
+
+        ChildA childA;
+        EXPECT_EQ(descriptor.cast(RTTI::TypeInfo<ParentB>::Id(), &childA),
+                  static_cast<ParentB*>(&childA));
+
+#ifdef RTTI_USE_TYPE_DESCRIPTOR
+        GrandParent& grandParent = childA;
+        EXPECT_EQ(&grandParent.typeDescriptor(), &descriptor);
+#endif
+    }
+
+    TEST(HierarchyTest, StaticCasting) {
+        static_assert(std::is_same_v<decltype(RTTI::cast<ParentA>(std::declval<ChildA*>())),
+                                     ParentA*>);
+        static_assert(std::is_same_v<decltype(RTTI::cast<ParentA>(std::declval<ChildA const*>())),
+                                     ParentA const*>);
+
+        ChildA childA;
+        EXPECT_EQ(RTTI::cast<GrandParent>(&childA), static_cast<GrandParent*>(&childA));
+        EXPECT_EQ(RTTI::cast<ParentB>(&childA), static_cast<ParentB*>(&childA));
+        EXPECT_EQ(RTTI::cast<GrandParent>(static_cast<ChildA*>(nullptr)), nullptr);
+        EXPECT_EQ(RTTI::cast<ChildA>(static_cast<GrandParent*>(nullptr)), nullptr);
+        EXPECT_TRUE(RTTI::is<ParentA>(&childA));
+        EXPECT_FALSE(RTTI::is<ParentA>(static_cast<ChildA*>(nullptr)));
+
+        ParentA* parentA = &childA;
+        EXPECT_EQ(RTTI::cast<ChildA>(parentA), &childA);
+        EXPECT_EQ(RTTI::cast<ChildFinal>(parentA), nullptr);
+        EXPECT_FALSE(RTTI::is<ChildFinal>(parentA));
+    }
+
+    TEST(HierarchyTest, FinalCasting) {
+        ChildFinal childFinal;
+        ParentA* parentA = &childFinal;
+        GrandParent* grandParent = &childFinal;
+
+        EXPECT_TRUE(parentA->is<ChildFinal>());
+        EXPECT_TRUE(grandParent->is<ChildFinal>());
+        EXPECT_EQ(parentA->cast<ChildFinal>(), &childFinal);
+        EXPECT_EQ(grandParent->cast<ChildFinal>(), &childFinal);
+        EXPECT_EQ(grandParent->cast<ChildA>(), nullptr);
+
+        ParentA parent;
+        EXPECT_FALSE(parent.is<ChildFinal>());
+        EXPECT_EQ(parent.cast<ChildFinal>(), nullptr);
+    }
+
     TEST(HierarchyTest, UpCasting) {
         ChildA childA;
         EXPECT_EQ(childA.cast<ChildA>(), &childA);
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <manifest.hh>
+#include <vector>
+
+namespace {
+    struct Shape : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Shape);
+    };
+
+    struct Named : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Named);
+    };
+
+    struct Circle : Shape {
+        RTTI_DECLARE_TYPEINFO(Circle, Shape);
+    };
+
+    struct Label
+        : Shape
+        , Named {
+        RTTI_DECLARE_TYPEINFO(Label, Shape, Named);
+    };
+
+    struct Unlisted : Shape {
+        RTTI_DECLARE_TYPEINFO(Unlisted, Shape);
+    };
+
+    RTTI::Manifest BuildManifest() {
+        RTTI::ManifestBuilder builder;
+        EXPECT_TRUE((builder.add<Shape, Named, Circle, Label>()));
+        EXPECT_TRUE(builder.add<Circle>());
+        EXPECT_EQ(builder.size(), 4u);
+        return builder.build();
+    }
+}  // namespace
+
+TEST(Manifest, QueriesTypesInPlace) {
+    auto const manifest = BuildManifest();
+
+    // Copy the manifest as another process would map it
+    std::vector<std::uint64_t> mapped((manifest.size() + 7) / 8);
+    std::memcpy(mapped.data(), manifest.data(), manifest.size());
+    RTTI::ManifestView const view(mapped.data(), manifest.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.size(), 4u);
+
+    auto const* label = view.find(Label::TypeInfo::Id());
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(view.name(*label), Label::TypeInfo::Name());
+    EXPECT_EQ(view.ancestors(*label).size(), 3u);
+    EXPECT_EQ(view.find(Unlisted::TypeInfo::Id()), nullptr);
+
+    EXPECT_TRUE(view.is(Label::TypeInfo::Id(), Named::TypeInfo::Id()));
+    EXPECT_TRUE(view.is(Circle::TypeInfo::Id(), Circle::TypeInfo::Id()));
+    EXPECT_FALSE(view.is(Circle::TypeInfo::Id(), Named::TypeInfo::Id()));
+    EXPECT_FALSE(view.is(Unlisted::TypeInfo::Id(), Shape::TypeInfo::Id()));
+
+    RTTI::TypeId previous = 0;
+    for (auto const& entry : view) {
+        EXPECT_GT(entry.id, previous);
+        previous = static_cast<RTTI::TypeId>(entry.id);
+    }
+}
+
+TEST(Manifest, MatchesTypesOfThisProcess) {
+    auto const manifest = BuildManifest();
+    auto const view = manifest.view();
+    ASSERT_TRUE(view);
+
+    EXPECT_TRUE(view.matches(Label::TypeInfo::Descriptor()));
+    EXPECT_TRUE(view.matches(Shape::TypeInfo::Descriptor()));
+    EXPECT_FALSE(view.matches(Unlisted::TypeInfo::Descriptor()));
+}
+
+TEST(Manifest, RejectsInvalidManifests) {
+    auto const manifest = BuildManifest();
+    std::vector<std::uint64_t> copy((manifest.size() + 7) / 8);
+    std::memcpy(copy.data(), manifest.data(), manifest.size());
+
+    EXPECT_FALSE(RTTI::ManifestView(nullptr, 0).valid());
+    EXPECT_FALSE(RTTI::ManifestView(copy.data(), manifest.size() - 1).valid());
+    EXPECT_FALSE(RTTI::ManifestView(copy.data(), sizeof(RTTI::ManifestHeader) - 1).valid());
+
+    auto* header = reinterpret_cast<RTTI::ManifestHeader*>(copy.data());
+    header->idBits = RTTI_TYPEID_BITS == 32 ? 64 : 32;
+    EXPECT_FALSE(RTTI::ManifestView(copy.data(), manifest.size()).valid());
+    header->idBits = RTTI_TYPEID_BITS;
+    EXPECT_TRUE(RTTI::ManifestView(copy.data(), manifest.size()).valid());
+
+    header->count += 1;
+    EXPECT_FALSE(RTTI::ManifestView(copy.data(), manifest.size()).valid());
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <pointer_cast.hh>
+#include <utility>
+
+namespace {
+    struct Shape : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Shape);
+    };
+
+    struct Named : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Named);
+    };
+
+    struct Label
+        : virtual Shape
+        , Named {
+        RTTI_DECLARE_TYPEINFO(Label, Shape, Named);
+
+    public:
+        static inline int Instances = 0;
+
+        Label() noexcept {
+            ++Instances;
+        }
+
+        ~Label() override {
+            --Instances;
+        }
+    };
+
+    struct Circle : Shape {
+        RTTI_DECLARE_TYPEINFO(Circle, Shape);
+    };
+
+    struct Node : virtual RTTI::RefCounted {
+        RTTI_DECLARE_TYPEINFO(Node, RTTI::RefCounted);
+    };
+
+    struct Branch : virtual Node {
+        RTTI_DECLARE_TYPEINFO(Branch, Node);
+    };
+
+    struct Leaf
+        : virtual Node
+        , Named {
+        RTTI_DECLARE_TYPEINFO(Leaf, Node, Named);
+
+    public:
+        static inline int Instances = 0;
+
+        Leaf() noexcept {
+            ++Instances;
+        }
+
+        Leaf(Leaf const& other) noexcept
+            : RTTI::RefCounted(other)
+            , Node(other)
+            , Named(other) {
+            ++Instances;
+        }
+
+        ~Leaf() override {
+            --Instances;
+        }
+    };
+}  // namespace
+
+TEST(PointerCast, SharedPtr) {
+    std::shared_ptr<Shape> shape = std::make_shared<Label>();
+    ASSERT_EQ(shape.use_count(), 1);
+
+    auto label = RTTI::dynamic_pointer_cast<Label>(shape);
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(label.get(), RTTI::cast<Label>(shape.get()));
+    EXPECT_EQ(shape.use_count(), 2);
+    EXPECT_EQ(RTTI::dynamic_pointer_cast<Circle>(shape), nullptr);
+    EXPECT_EQ(shape.use_count(), 2);
+
+    // Downcasts through a virtual base are resolved by the lookup
+    auto const named = RTTI::static_pointer_cast<Named>(shape);
+    EXPECT_EQ(named.get(), static_cast<Named*>(label.get()));
+    std::shared_ptr<Shape const> constShape = shape;
+    std::shared_ptr<Label const> constLabel = RTTI::static_pointer_cast<Label>(constShape);
+    EXPECT_EQ(constLabel.get(), label.get());
+
+    label.reset();
+    auto const* object = named.get();
+    auto moved = RTTI::dynamic_pointer_cast<Named>(std::move(shape));
+#if __cplusplus > 201703L
+    EXPECT_EQ(shape, nullptr);
+#else
+    // Before C++20 rvalues are copied, which touches the count once
+    EXPECT_EQ(shape.use_count(), 5);
+    shape.reset();
+#endif
+    EXPECT_EQ(moved.get(), object);
+
+    // A failing cast leaves the source untouched
+    auto missed = RTTI::dynamic_pointer_cast<Circle>(std::move(moved));
+    EXPECT_EQ(missed, nullptr);
+    EXPECT_EQ(moved.get(), object);
+
+    moved.reset();
+    constShape.reset();
+    constLabel.reset();
+    EXPECT_EQ(Label::Instances, 1);
+}
+
+TEST(PointerCast, UniquePtr) {
+    {
+        std::unique_ptr<Shape> shape = std::make_unique<Label>();
+        auto* const object = RTTI::cast<Label>(shape.get());
+
+        std::unique_ptr<Circle> circle = RTTI::dynamic_pointer_cast<Circle>(std::move(shape));
+        EXPECT_EQ(circle, nullptr);
+        ASSERT_NE(shape, nullptr);
+
+        std::unique_ptr<Named> named = RTTI::dynamic_pointer_cast<Named>(std::move(shape));
+        EXPECT_EQ(shape, nullptr);
+        EXPECT_EQ(named.get(), static_cast<Named*>(object));
+        EXPECT_EQ(Label::Instances, 1);
+    }
+    EXPECT_EQ(Label::Instances, 0);
+
+    // Custom deleters are moved along
+    int deleted = 0;
+    auto deleter = [&deleted](Shape* shape) {
+        ++deleted;
+        delete shape;
+    };
+    {
+        std::unique_ptr<Shape, decltype(deleter)> shape(new Label(), deleter);
+        auto label = RTTI::dynamic_pointer_cast<Label>(std::move(shape));
+        static_assert(std::is_same_v<decltype(label), std::unique_ptr<Label, decltype(deleter)>>);
+        EXPECT_EQ(shape, nullptr);
+        EXPECT_NE(label, nullptr);
+    }
+    EXPECT_EQ(deleted, 1);
+    EXPECT_EQ(Label::Instances, 0);
+}
+
+TEST(PointerCast, Ref) {
+    {
+        RTTI::Ref<Leaf> leaf = RTTI::make_ref<Leaf>();
+        EXPECT_EQ(leaf->refCount(), 1u);
+
+        RTTI::Ref<Node> node = leaf;
+        EXPECT_EQ(leaf->refCount(), 2u);
+        EXPECT_EQ(node, leaf);
+
+        RTTI::Ref<Node> copy;
+        copy = node;
+        EXPECT_EQ(leaf->refCount(), 3u);
+        copy.reset();
+        EXPECT_EQ(copy, nullptr);
+        EXPECT_EQ(leaf->refCount(), 2u);
+
+        // Copies of the object are referenced separately
+        Leaf value(*leaf);
+        EXPECT_EQ(value.refCount(), 0u);
+        EXPECT_EQ(Leaf::Instances, 2);
+
+        node = std::move(leaf);
+        EXPECT_EQ(leaf, nullptr);
+        EXPECT_EQ(node->refCount(), 1u);
+    }
+    EXPECT_EQ(Leaf::Instances, 0);
+}
+
+TEST(PointerCast, RefCast) {
+    RTTI::Ref<Node> node = RTTI::make_ref<Leaf>();
+    auto* const object = node.get();
+
+    auto copy = RTTI::dynamic_pointer_cast<Leaf>(node);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_EQ(copy.get(), RTTI::cast<Leaf>(object));
+    EXPECT_EQ(node->refCount(), 2u);
+    copy.reset();
+
+    // Moving casts leave the reference count untouched
+    auto leaf = RTTI::dynamic_pointer_cast<Leaf>(std::move(node));
+    EXPECT_EQ(node, nullptr);
+    ASSERT_NE(leaf, nullptr);
+    EXPECT_EQ(leaf->refCount(), 1u);
+
+    auto back = RTTI::static_pointer_cast<Node>(std::move(leaf));
+    EXPECT_EQ(back.get(), object);
+    EXPECT_EQ(back->refCount(), 1u);
+
+    auto const missed = RTTI::dynamic_pointer_cast<Branch>(std::move(back));
+    EXPECT_EQ(missed, nullptr);
+    EXPECT_EQ(back.get(), object);
+
+    auto const down = RTTI::static_pointer_cast<Leaf>(back);
+    EXPECT_EQ(back->refCount(), 2u);
+    back.reset();
+    EXPECT_EQ(down->refCount(), 1u);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <poly_vector.hh>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Entity : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Entity);
+
+    public:
+        explicit Entity(int id) : id(id) {}
+        int id;
+    };
+
+    struct Movable : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Movable);
+
+    public:
+        float velocity = 1.0f;
+    };
+
+    struct Player
+        : Entity
+        , Movable {
+        RTTI_DECLARE_TYPEINFO(Player, Entity, Movable);
+
+    public:
+        Player(int id, std::string name) : Entity(id), name(std::move(name)) {}
+        std::string name;
+    };
+
+    struct Npc
+        : Entity
+        , Movable {
+        RTTI_DECLARE_TYPEINFO(Npc, Entity, Movable);
+
+    public:
+        using Entity::Entity;
+    };
+
+    struct Wall : Entity {
+        RTTI_DECLARE_TYPEINFO(Wall, Entity);
+
+    public:
+        using Entity::Entity;
+    };
+
+    struct Fragile : Entity {
+        RTTI_DECLARE_TYPEINFO(Fragile, Entity);
+
+    public:
+        explicit Fragile(int id) : Entity(id) {
+            if (id < 0) {
+                throw std::invalid_argument("negative id");
+            }
+        }
+    };
+
+    template <typename T>
+    std::vector<int> Ids(RTTI::PolyVector<Entity> const& entities) {
+        std::vector<int> ids;
+        entities.for_each<T>([&](T const& object) { ids.push_back(RTTI::cast<Entity>(&object)->id); });
+        return ids;
+    }
+
+    TEST(PolyVectorTest, ForEachVisitsDerivedArenas) {
+        RTTI::PolyVector<Entity> entities;
+        entities.emplace<Player>(1, "one");
+        entities.emplace<Wall>(2);
+        entities.emplace<Npc>(3);
+        entities.emplace<Player>(4, "four");
+        entities.emplace<Wall>(5);
+
+        EXPECT_EQ(entities.size(), 5u);
+        EXPECT_EQ(entities.count<Movable>(), 3u);
+        EXPECT_EQ(entities.count<Wall>(), 2u);
+
+        // Objects are grouped by type, in insertion order within each type.
+        EXPECT_EQ(Ids<Entity>(entities), (std::vector<int>{1, 4, 2, 5, 3}));
+        EXPECT_EQ(Ids<Player>(entities), (std::vector<int>{1, 4}));
+        EXPECT_EQ(Ids<Wall>(entities), (std::vector<int>{2, 5}));
+
+        std::vector<float> velocities;
+        entities.for_each<Movable>([&](Movable& movable) {
+            movable.velocity *= 2.0f;
+            velocities.push_back(movable.velocity);
+        });
+        EXPECT_EQ(velocities, (std::vector<float>{2.0f, 2.0f, 2.0f}));
+
+        std::vector<std::string> names;
+        entities.for_each<Player>([&](Player& player) { names.push_back(player.name); });
+        EXPECT_EQ(names, (std::vector<std::string>{"one", "four"}));
+    }
+
+    TEST(PolyVectorTest, StableHandles) {
+        RTTI::PolyVector<Entity> entities;
+        std::vector<RTTI::PolyHandle> handles;
+        for (int i = 0; i < 100; ++i) {
+            handles.push_back(i % 2 ? entities.emplace<Npc>(i) : entities.emplace<Wall>(i));
+        }
+        for (int i = 0; i < 100; i += 3) {
+            EXPECT_TRUE(entities.erase(handles[i]));
+            EXPECT_FALSE(entities.erase(handles[i]));
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            if (i % 3 == 0) {
+                EXPECT_FALSE(entities.contains(handles[i]));
+                EXPECT_EQ(entities.get(handles[i]), nullptr);
+            } else {
+                ASSERT_NE(entities.get(handles[i]), nullptr);
+                EXPECT_EQ(entities.get(handles[i])->id, i);
+                EXPECT_EQ(entities.get<Movable>(handles[i]) != nullptr, i % 2 == 1);
+            }
+        }
+
+        // Released handles are reused with a new generation.
+        auto const handle = entities.emplace<Wall>(1000);
+        EXPECT_EQ(entities.get(handle)->id, 1000);
+        EXPECT_FALSE(entities.contains(handles[99]));
+    }
+
+    TEST(PolyVectorTest, ThrowingConstructor) {
+        RTTI::PolyVector<Entity> entities;
+        auto const first = entities.emplace<Fragile>(1);
+        EXPECT_THROW(entities.emplace<Fragile>(-1), std::invalid_argument);
+        EXPECT_EQ(entities.size(), 1u);
+        EXPECT_EQ(Ids<Fragile>(entities), (std::vector<int>{1}));
+
+        auto const second = entities.emplace<Fragile>(2);
+        EXPECT_EQ(entities.size(), 2u);
+        EXPECT_EQ(entities.get(first)->id, 1);
+        EXPECT_EQ(entities.get(second)->id, 2);
+        EXPECT_TRUE(entities.erase(first));
+        EXPECT_EQ(Ids<Fragile>(entities), (std::vector<int>{2}));
+    }
+
+    TEST(PolyVectorTest, EraseIf) {
+        RTTI::PolyVector<Entity> entities;
+        std::vector<RTTI::PolyHandle> handles;
+        for (int i = 0; i < 30; ++i) {
+            switch (i % 3) {
+                case 0: handles.push_back(entities.emplace<Player>(i, "player")); break;
+                case 1: handles.push_back(entities.emplace<Npc>(i)); break;
+                default: handles.push_back(entities.emplace<Wall>(i)); break;
+            }
+        }
+
+        auto const erased = entities.erase_if<Movable>(
+            [](Movable const& movable) { return movable.cast<Entity>()->id % 2 == 0; });
+        EXPECT_EQ(erased, 10u);
+        EXPECT_EQ(entities.size(), 20u);
+
+        for (int i = 0; i < 30; ++i) {
+            bool const removed = i % 3 != 2 && i % 2 == 0;
+            EXPECT_EQ(entities.contains(handles[i]), !removed);
+            if (!removed) {
+                EXPECT_EQ(entities.get(handles[i])->id, i);
+            }
+        }
+        EXPECT_EQ(Ids<Player>(entities), (std::vector<int>{3, 9, 15, 21, 27}));
+
+        entities.shrink_to_fit();
+        entities.clear();
+        EXPECT_TRUE(entities.empty());
+        EXPECT_FALSE(entities.contains(handles[1]));
+        EXPECT_TRUE(Ids<Entity>(entities).empty());
+    }
+}  // namespace
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <registry.hh>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Message : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Message);
+
+    public:
+        virtual int kind() const {
+            return 0;
+        }
+    };
+
+    struct Ping : Message {
+        RTTI_DECLARE_TYPEINFO(Ping, Message);
+
+    public:
+        int kind() const override {
+            return 1;
+        }
+        std::string payload = "ping";
+    };
+
+    struct Pong : Message {
+        RTTI_DECLARE_TYPEINFO(Pong, Message);
+
+    public:
+        int kind() const override {
+            return 2;
+        }
+    };
+
+    struct Unrelated : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Unrelated);
+    };
+
+    struct NotDefaultConstructible : Message {
+        RTTI_DECLARE_TYPEINFO(NotDefaultConstructible, Message);
+
+    public:
+        explicit NotDefaultConstructible(int) {}
+    };
+
+    struct Unregistered : Message {
+        RTTI_DECLARE_TYPEINFO(Unregistered, Message);
+    };
+
+    /// Pooled alone in its pool, as no other type has its size and alignment.
+    struct Released : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Released);
+
+    public:
+        alignas(64) char data[64] = {};
+    };
+
+    /// Holds a pooled object until the thread local destructors of its thread run.
+    struct ReleasedHolder {
+        RTTI::Pooled<Released> object;
+    };
+
+    RTTI_REGISTER(Message);
+    RTTI_REGISTER(Ping);
+    RTTI_REGISTER(Pong);
+    RTTI_REGISTER(Pong);
+    RTTI_REGISTER(Unrelated);
+    RTTI_REGISTER(NotDefaultConstructible);
+
+    RTTI_ASSERT_UNIQUE_IDS(Message, Ping, Pong, Unrelated, NotDefaultConstructible);
+
+    TEST(RegistryTest, Find) {
+        auto const* ping = RTTI::Registry::find(RTTI::TypeInfo<Ping>::Id());
+        ASSERT_NE(ping, nullptr);
+        EXPECT_EQ(ping->name, Ping::TypeInfo::Name());
+        EXPECT_EQ(RTTI::Registry::find(Ping::TypeInfo::Name()), ping);
+
+        EXPECT_EQ(RTTI::Registry::find(RTTI::TypeInfo<Unregistered>::Id()), nullptr);
+        EXPECT_EQ(RTTI::Registry::find("Unregistered"), nullptr);
+
+        // Duplicate registrations are merged.
+        std::size_t pongs = 0;
+        for (auto const* entry : RTTI::Registry::entries()) {
+            pongs += entry->id == RTTI::TypeInfo<Pong>::Id() ? 1 : 0;
+        }
+        EXPECT_EQ(pongs, 1u);
+    }
+
+    TEST(RegistryTest, CreateById) {
+        auto ping = RTTI::create<Message>(RTTI::TypeInfo<Ping>::Id());
+        ASSERT_NE(ping, nullptr);
+        EXPECT_EQ(ping->kind(), 1);
+        EXPECT_EQ(ping->cast<Ping>()->payload, "ping");
+
+        auto pong = RTTI::create(Pong::TypeInfo::Name());
+        ASSERT_NE(pong, nullptr);
+        EXPECT_EQ(pong->typeId(), RTTI::TypeInfo<Pong>::Id());
+
+        EXPECT_EQ(RTTI::create<Message>(RTTI::TypeInfo<Unrelated>::Id()), nullptr);
+        EXPECT_EQ(RTTI::create(RTTI::TypeInfo<NotDefaultConstructible>::Id()), nullptr);
+        EXPECT_EQ(RTTI::create<Message>(RTTI::TypeInfo<NotDefaultConstructible>::Id()), nullptr);
+        EXPECT_EQ(RTTI::create(RTTI::TypeInfo<Unregistered>::Id()), nullptr);
+    }
+
+    TEST(RegistryTest, PoolsReuseMemory) {
+        std::vector<RTTI::Pooled<Message>> messages;
+        for (int i = 0; i < 1000; ++i) {
+            messages.push_back(RTTI::create<Message>(RTTI::TypeInfo<Ping>::Id()));
+        }
+        void* const first = messages.front().get();
+        messages.clear();
+
+        bool reused = false;
+        for (int i = 0; i < 1000; ++i) {
+            messages.push_back(RTTI::create<Message>(RTTI::TypeInfo<Ping>::Id()));
+            reused |= messages.back().get() == first;
+        }
+        EXPECT_TRUE(reused);
+
+        auto pooled = RTTI::make_pooled<NotDefaultConstructible>(42);
+        EXPECT_TRUE(pooled->is<Message>());
+    }
+
+    TEST(RegistryTest, PoolsAcceptObjectsAfterThreadExit) {
+        void* released = nullptr;
+        std::thread([&released] {
+            // Constructed before the free list of the thread, hence destroyed after it
+            thread_local ReleasedHolder holder;
+            holder.object = RTTI::make_pooled<Released>();
+            released = holder.object.get();
+        }).join();
+
+        // The chunk released after the free list was destroyed went to the shared list
+        std::vector<RTTI::Pooled<Released>> objects;
+        bool reused = false;
+        for (int i = 0; i < 64; ++i) {
+            objects.push_back(RTTI::make_pooled<Released>());
+            reused |= objects.back().get() == released;
+        }
+        EXPECT_TRUE(reused);
+    }
+}  // namespace
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <rtti.hh>
+
+struct Shape : RTTI::EnableRoot<Shape> {
+    RTTI_DECLARE_TYPEINFO(Shape);
+};
+
+struct Polygon : Shape {
+    RTTI_DECLARE_TYPEINFO(Polygon, Shape);
+};
+
+struct Square : Polygon {
+    RTTI_DECLARE_TYPEINFO(Square, Polygon);
+};
+
+struct Circle : Shape {
+    RTTI_DECLARE_TYPEINFO(Circle, Shape);
+};
+
+struct Unrelated {};
+
+namespace {
+    TEST(RootTest, NoVirtualBase) {
+        EXPECT_EQ(sizeof(Shape), sizeof(void*));
+        EXPECT_EQ(sizeof(Square), sizeof(void*));
+    }
+
+    TEST(RootTest, TypeIdentification) {
+        Square square;
+        Shape& shape = square;
+        EXPECT_EQ(shape.typeId(), RTTI::TypeInfo<Square>::Id());
+        EXPECT_TRUE(shape.is<Shape>());
+        EXPECT_TRUE(shape.is<Polygon>());
+        EXPECT_TRUE(shape.is<Square>());
+        EXPECT_FALSE(shape.is<Circle>());
+    }
+
+    TEST(RootTest, DownCasting) {
+        Square square;
+        Shape* shape = &square;
+        EXPECT_EQ(shape->cast<Square>(), &square);
+        EXPECT_EQ(shape->cast<Polygon>(), static_cast<Polygon*>(&square));
+        EXPECT_EQ(shape->cast<Shape>(), shape);
+        EXPECT_EQ(shape->cast<Circle>(), nullptr);
+        EXPECT_EQ(shape->cast<Unrelated>(), nullptr);
+
+        Shape const* constShape = &square;
+        EXPECT_EQ(constShape->cast<Square>(), &square);
+        EXPECT_EQ(constShape->cast<Circle>(), nullptr);
+
+        RTTI::Enable* base = &square;
+        EXPECT_EQ(base->cast<Polygon>(), static_cast<Polygon*>(&square));
+    }
+}  // namespace
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <stats.hh>
+#include <string>
+#include <thread>
+
+namespace {
+    struct Animal : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Animal);
+    };
+
+    struct Pet : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Pet);
+    };
+
+    struct Dog
+        : Animal
+        , Pet {
+        RTTI_DECLARE_TYPEINFO(Dog, Animal, Pet);
+    };
+
+    struct Wolf : Animal {
+        RTTI_DECLARE_TYPEINFO(Wolf, Animal);
+    };
+
+    /// Returns the counters of the passed pair, zero if not counted.
+    template <typename Dynamic, typename Target>
+    RTTI::Stats::Entry Find(RTTI::Stats::Snapshot const& snapshot) {
+        for (auto const& entry : snapshot.entries) {
+            if (entry.dynamicId == Dynamic::TypeInfo::Id() &&
+                entry.targetId == Target::TypeInfo::Id()) {
+                return entry;
+            }
+        }
+        return RTTI::Stats::Entry{Dynamic::TypeInfo::Id(), Target::TypeInfo::Id(), {}, {}, 0, 0, 0};
+    }
+
+    /// Returns the counters of the passed pair counted between the two snapshots.
+    template <typename Dynamic, typename Target>
+    RTTI::Stats::Entry Delta(RTTI::Stats::Snapshot const& before,
+                             RTTI::Stats::Snapshot const& after) {
+        auto delta = Find<Dynamic, Target>(after);
+        auto const base = Find<Dynamic, Target>(before);
+        delta.hits -= base.hits;
+        delta.misses -= base.misses;
+        delta.visited -= base.visited;
+        return delta;
+    }
+}  // namespace
+
+TEST(Stats, CountsCastsAndTypeChecks) {
+    Dog dog;
+    Wolf wolf;
+    Animal* animals[] = {&dog, &wolf};
+
+    auto const before = RTTI::Stats::Collect();
+    for (auto* animal : animals) {
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_EQ(animal->cast<Pet>() != nullptr, animal == &dog);
+            EXPECT_EQ(animal->is<Dog>(), animal == &dog);
+        }
+    }
+    auto const after = RTTI::Stats::Collect();
+
+    if constexpr (!RTTI::Stats::Enabled) {
+        EXPECT_TRUE(after.entries.empty());
+        EXPECT_EQ(after.toJson(), "{\"enabled\":false,\"dropped\":0,\"entries\":[]}");
+        return;
+    }
+
+    auto const dogPet = Delta<Dog, Pet>(before, after);
+    EXPECT_EQ(dogPet.hits, 3u);
+    EXPECT_EQ(dogPet.misses, 0u);
+    EXPECT_GE(dogPet.visited, 3u);
+    EXPECT_EQ(dogPet.dynamicName, Dog::TypeInfo::Name());
+    EXPECT_EQ(dogPet.targetName, Pet::TypeInfo::Name());
+
+    auto const wolfDog = Delta<Wolf, Dog>(before, after);
+    EXPECT_EQ(wolfDog.hits, 0u);
+    EXPECT_EQ(wolfDog.misses, 3u);
+    EXPECT_EQ(wolfDog.dynamicName, Wolf::TypeInfo::Name());
+
+    auto const wolfPet = Delta<Wolf, Pet>(before, after);
+    EXPECT_EQ(wolfPet.misses, 3u);
+    auto const dogDog = Delta<Dog, Dog>(before, after);
+    EXPECT_EQ(dogDog.hits, 3u);
+}
+
+TEST(Stats, SumsCountersOfAllThreads) {
+    Dog dog;
+    Animal* animal = &dog;
+    auto const before = RTTI::Stats::Collect();
+
+    std::thread exited([animal] {
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_NE(animal->cast<Pet>(), nullptr);
+        }
+    });
+    exited.join();
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_NE(animal->cast<Pet>(), nullptr);
+    }
+
+    auto const snapshot = RTTI::Stats::Collect();
+    auto const dogPet = Delta<Dog, Pet>(before, snapshot);
+    EXPECT_EQ(dogPet.hits, RTTI::Stats::Enabled ? 110u : 0u);
+
+    auto const json = snapshot.toJson();
+    if (RTTI::Stats::Enabled) {
+        EXPECT_NE(json.find("{\"dynamic\":\"" + std::string(Dog::TypeInfo::Name()) +
+                            "\",\"target\":\"" + std::string(Pet::TypeInfo::Name()) +
+                            "\",\"hits\":"),
+                  std::string::npos);
+    }
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_map.hh>
+#include <vector>
+
+namespace {
+    struct Shape : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Shape);
+    };
+
+    struct Named : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Named);
+    };
+
+    struct Polygon : Shape {
+        RTTI_DECLARE_TYPEINFO(Polygon, Shape);
+    };
+
+    struct Square : Polygon {
+        RTTI_DECLARE_TYPEINFO(Square, Polygon);
+    };
+
+    struct Label
+        : Square
+        , Named {
+        RTTI_DECLARE_TYPEINFO(Label, Square, Named);
+    };
+
+    struct Circle : Shape {
+        RTTI_DECLARE_TYPEINFO(Circle, Shape);
+    };
+
+    struct Unrelated : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Unrelated);
+    };
+
+    template <std::size_t N>
+    struct Generated : Polygon {
+        RTTI_DECLARE_TYPEINFO(Generated, Polygon);
+    };
+
+    template <std::size_t... Ns>
+    void InsertGenerated(RTTI::TypeMap<std::string>& map, std::index_sequence<Ns...>) {
+        (map.insert<Generated<Ns>>("generated"), ...);
+    }
+
+    template <std::size_t... Ns>
+    std::vector<std::unique_ptr<RTTI::Enable>> MakeGenerated(std::index_sequence<Ns...>) {
+        std::vector<std::unique_ptr<RTTI::Enable>> objects;
+        (objects.push_back(std::make_unique<Generated<Ns>>()), ...);
+        return objects;
+    }
+}  // namespace
+
+TEST(TypeMap, Find) {
+    RTTI::TypeMap<std::string> map;
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_TRUE(map.insert<Shape>("shape"));
+    EXPECT_TRUE(map.emplace<Polygon>(3, 'p'));
+    EXPECT_FALSE(map.insert<Shape>("again"));
+    EXPECT_EQ(map.size(), 2u);
+
+    ASSERT_NE(map.find<Shape>(), nullptr);
+    EXPECT_EQ(*map.find<Shape>(), "shape");
+    EXPECT_EQ(*map.find(Polygon::TypeInfo::Id()), "ppp");
+    EXPECT_EQ(map.find<Square>(), nullptr);
+
+    // Growing keeps the values in place
+    auto const* shape = map.find<Shape>();
+    InsertGenerated(map, std::make_index_sequence<64>{});
+    EXPECT_EQ(map.size(), 66u);
+    EXPECT_EQ(map.find<Shape>(), shape);
+    EXPECT_EQ(*map.find<Generated<63>>(), "generated");
+}
+
+TEST(TypeMap, FindNearest) {
+    RTTI::TypeMap<std::string> map;
+    map.insert<Shape>("shape");
+    map.insert<Named>("named");
+
+    Label label;
+    Circle circle;
+    Unrelated unrelated;
+    EXPECT_EQ(map.find_nearest(nullptr), nullptr);
+    EXPECT_EQ(*map.find_nearest(&circle), "shape");
+    EXPECT_EQ(*map.find_nearest(&circle), "shape");
+    EXPECT_EQ(map.find_nearest(&unrelated), nullptr);
+
+    // Unrelated ancestors of equal depth resolve in the order of insertion
+    EXPECT_EQ(*map.find_nearest(&label), "shape");
+
+    // Inserting a nearer ancestor invalidates the memoized one
+    map.insert<Polygon>("polygon");
+    EXPECT_EQ(*map.find_nearest(&label), "polygon");
+    EXPECT_EQ(*map.find_nearest(&circle), "shape");
+    map.insert<Label>("label");
+    EXPECT_EQ(*map.find_nearest(&label), "label");
+    map.insert<Unrelated>("unrelated");
+    EXPECT_EQ(*map.find_nearest(&unrelated), "unrelated");
+
+    // The memo grows beyond its initial capacity
+    auto const objects = MakeGenerated(std::make_index_sequence<64>{});
+    for (auto const& object : objects) {
+        EXPECT_EQ(*map.find_nearest(object.get()), "polygon");
+    }
+    for (auto const& object : objects) {
+        EXPECT_EQ(*map.find_nearest(object.get()), "polygon");
+    }
+}
+
+TEST(TypeMap, ConcurrentInsert) {
+    RTTI::TypeMap<std::string> map;
+    map.insert<Shape>("shape");
+
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> failures{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            Label label;
+            Circle circle;
+            while (!done.load()) {
+                auto const* nearest = map.find_nearest(&label);
+                if (nearest == nullptr || (*nearest != "shape" && *nearest != "polygon")) {
+                    ++failures;
+                }
+                if (map.find_nearest(&circle) == nullptr) {
+                    ++failures;
+                }
+            }
+        });
+    }
+
+    map.insert<Polygon>("polygon");
+    InsertGenerated(map, std::make_index_sequence<64>{});
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failures.load(), 0u);
+
+    Label label;
+    EXPECT_EQ(*map.find_nearest(&label), "polygon");
+}
+
+TEST(TypeMap, MemoClearsInPlace) {
+    RTTI::Detail::TypeMemo memo(4);
+    auto const id = Label::TypeInfo::Id();
+    memo.insert(memo.find(id), id, 1);
+    EXPECT_EQ(memo.find(id).value, 1u);
+
+    // Values computed from a lookup before clearing are ignored
+    auto const stale = memo.find(Circle::TypeInfo::Id());
+    memo.clear();
+    EXPECT_EQ(memo.find(id).value, 0u);
+    memo.insert(stale, Circle::TypeInfo::Id(), 2);
+    EXPECT_EQ(memo.find(Circle::TypeInfo::Id()).value, 0u);
+
+    // The slots of the cleared values are reused
+    auto const found = memo.find(id);
+    EXPECT_EQ(found.value, 0u);
+    memo.insert(found, id, 3);
+    EXPECT_EQ(memo.find(id).value, 3u);
+    EXPECT_EQ(memo.find(id).table, found.table);
+}
+
+TEST(TypeMap, Frozen) {
+    static constexpr RTTI::FrozenTypeMap<int, Shape, Named, Polygon> map(1, 2, 3);
+    static_assert(map.size() == 3);
+    static_assert(*map.find<Shape>() == 1);
+    static_assert(*map.find<Polygon>() == 3);
+    static_assert(map.find<Square>() == nullptr);
+    static_assert(*map.find(Named::TypeInfo::Id()) == 2);
+
+    Label label;
+    Circle circle;
+    Polygon polygon;
+    Unrelated unrelated;
+    EXPECT_EQ(*map.find_nearest(&label), 3);
+    EXPECT_EQ(*map.find_nearest(&circle), 1);
+    EXPECT_EQ(*map.find_nearest(&polygon), 3);
+    EXPECT_EQ(map.find_nearest(&unrelated), nullptr);
+    EXPECT_EQ(map.find_nearest(nullptr), nullptr);
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <map>
 #include <rtti.hh>
+#include <string>
 #include <typeinfo>
+#include <vector>
 
 using namespace RTTI;
 
@@ -39,4 +42,57 @@ TEST(TypeInfo, TypesAndReferencesToTypesAreEqual) {
 
     EXPECT_EQ(typeid(int), typeid(int&&));
     EXPECT_EQ(TypeInfo<int>::Id(), TypeInfo<int&&>::Id());
-}
\ No newline at end of file
+}
+
+namespace {
+    struct Anonymous {};
+
+    template <typename T, std::size_t N>
+    struct Sized {};
+
+    constexpr bool CanonicalEquals(std::string_view raw, std::string_view expected) {
+        char buffer[128] = {};
+        auto const length = RTTI::Detail::CanonicalizeTypeName(raw, buffer);
+        return std::string_view(buffer, length) == expected;
+    }
+}  // namespace
+
+#ifndef RTTI_RAW_TYPE_NAMES
+TEST(TypeInfo, TypeNamesAreCanonical) {
+    EXPECT_EQ(TypeName<unsigned long>(), "unsigned long");
+    EXPECT_EQ(TypeName<long long>(), "long long");
+    EXPECT_EQ(TypeName<short>(), "short");
+    EXPECT_EQ(TypeName<char const* const*>(), "const char*const*");
+    EXPECT_EQ(TypeName<std::string>(), "std::basic_string<char>");
+    using Nested = Sized<std::vector<Anonymous>, 4>;
+    EXPECT_EQ(TypeName<Nested>(), "{anonymous}::Sized<std::vector<{anonymous}::Anonymous>,4>");
+    EXPECT_EQ(TypeName<void (*)(int, long)>(), "void(*)(int,long)");
+    EXPECT_EQ(TypeName<int[3]>(), "int[3]");
+}
+
+TEST(TypeInfo, CompilerSpellingsAreCanonicalized) {
+    // GCC and Clang spellings of the same types
+    static_assert(CanonicalEquals("Sized<std::vector<{anonymous}::Anonymous> >, 4>",
+                                  "Sized<std::vector<{anonymous}::Anonymous>>,4>"));
+    static_assert(CanonicalEquals("Sized<std::vector<(anonymous namespace)::Anonymous>>, 4UL>",
+                                  "Sized<std::vector<{anonymous}::Anonymous>>,4>"));
+    static_assert(CanonicalEquals("std::__cxx11::basic_string<char>", "std::basic_string<char>"));
+    static_assert(CanonicalEquals("std::__1::basic_string<char>", "std::basic_string<char>"));
+    static_assert(CanonicalEquals("std::map<long unsigned int, short int>",
+                                  "std::map<unsigned long,short>"));
+    static_assert(CanonicalEquals("std::map<unsigned long, short>",
+                                  "std::map<unsigned long,short>"));
+    static_assert(CanonicalEquals("const char *const *", "const char*const*"));
+
+    // Identifiers which merely look like the rewritten spellings are left alone
+    static_assert(CanonicalEquals("long_int<my__1::x, u8>", "long_int<my__1::x,u8>"));
+    static_assert(CanonicalEquals("Vec3f", "Vec3f"));
+    EXPECT_TRUE(CanonicalEquals("Sized<int, 16ULL>", "Sized<int,16>"));
+}
+#endif
+
+TEST(TypeInfo, CanonicalTypeNamesAreHashed) {
+    using Map = std::map<int, Anonymous>;
+    EXPECT_EQ(TypeInfo<Map>::Id(), HashTypeName(TypeName<Map>()));
+    EXPECT_NE(TypeInfo<unsigned long>::Id(), TypeInfo<unsigned long long>::Id());
+}
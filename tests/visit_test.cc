@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <stats.hh>
+#include <string>
+#include <visit.hh>
+
+namespace {
+    struct Message : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Message);
+    };
+
+    struct Request : Message {
+        RTTI_DECLARE_TYPEINFO(Request, Message);
+    };
+
+    struct Tagged : virtual RTTI::Enable {
+        RTTI_DECLARE_TYPEINFO(Tagged);
+
+    public:
+        int tag = 7;
+    };
+
+    struct GetRequest
+        : Request
+        , Tagged {
+        RTTI_DECLARE_TYPEINFO(GetRequest, Request, Tagged);
+    };
+
+    struct PutRequest : Request {
+        RTTI_DECLARE_TYPEINFO(PutRequest, Request);
+    };
+
+    struct Response : Message {
+        RTTI_DECLARE_TYPEINFO(Response, Message);
+    };
+}  // namespace
+
+namespace Shapes {
+    struct Shape : RTTI::EnableRoot<Shape> {
+        RTTI_DECLARE_TYPEINFO(Shape);
+    };
+
+    struct Circle : Shape {
+        RTTI_DECLARE_TYPEINFO(Circle, Shape);
+    };
+
+    struct Square : Shape {
+        RTTI_DECLARE_TYPEINFO(Square, Shape);
+    };
+
+    struct Cube : Square {
+        RTTI_DECLARE_TYPEINFO(Cube, Square);
+    };
+}  // namespace Shapes
+
+RTTI_DECLARE_SEALED(Shapes::Shape, Shapes::Circle, Shapes::Square, Shapes::Cube);
+
+namespace {
+    /// Returns the number of ancestor table lookups so far, dropped ones included.
+    std::uint64_t Lookups() {
+        auto const snapshot = RTTI::Stats::Collect();
+        auto lookups = snapshot.dropped;
+        for (auto const& entry : snapshot.entries) {
+            lookups += entry.hits + entry.misses;
+        }
+        return lookups;
+    }
+
+    std::string Describe(Message& message) {
+        return RTTI::visit(
+            message, [](GetRequest&) { return std::string("get"); },
+            [](Request&) { return std::string("request"); },
+            [](Tagged& tagged) { return "tagged " + std::to_string(tagged.tag); });
+    }
+
+    TEST(VisitTest, ExactMatch) {
+        GetRequest get;
+        EXPECT_EQ(Describe(get), "get");
+    }
+
+    TEST(VisitTest, MostDerivedBase) {
+        PutRequest put;
+        EXPECT_EQ(Describe(put), "request");
+
+        Response response;
+        EXPECT_EQ(Describe(response), "");
+    }
+
+    TEST(VisitTest, BaseHandlerIsMemoized) {
+        if (!RTTI::Stats::Enabled) {
+            GTEST_SKIP() << "Lookups are only counted with RTTI_ENABLE_STATS defined.";
+        }
+        PutRequest put;
+        EXPECT_EQ(Describe(put), "request");
+
+        // Only the cast into the handled base is looked up once memoized
+        auto const before = Lookups();
+        EXPECT_EQ(Describe(put), "request");
+        EXPECT_EQ(Lookups() - before, 1u);
+    }
+
+    TEST(VisitTest, ConstExactMatch) {
+        if (!RTTI::Stats::Enabled) {
+            GTEST_SKIP() << "Lookups are only counted with RTTI_ENABLE_STATS defined.";
+        }
+        GetRequest const get;
+        Message const& message = get;
+
+        auto const before = Lookups();
+        auto const tag = RTTI::visit(
+            message, [](GetRequest const& request) { return request.tag; },
+            [](Message const&) { return 0; });
+        EXPECT_EQ(tag, 7);
+        EXPECT_EQ(Lookups(), before);
+    }
+
+    TEST(VisitTest, CrossCast) {
+        GetRequest get;
+        Message& message = get;
+        auto tag = RTTI::visit(message, [](Tagged const& tagged) { return tagged.tag; });
+        EXPECT_EQ(tag, 7);
+    }
+
+    TEST(VisitTest, Pointers) {
+        GetRequest get;
+        Message const* message = &get;
+        int calls = 0;
+        RTTI::visit(message, [&](Request const&) { ++calls; });
+        RTTI::visit(static_cast<Message const*>(nullptr), [&](Request const&) { ++calls; });
+        EXPECT_EQ(calls, 1);
+    }
+
+    TEST(VisitTest, SealedHierarchy) {
+        Shapes::Circle circle;
+        Shapes::Cube cube;
+        Shapes::Shape shape;
+
+        auto describe = [](Shapes::Shape& s) {
+            return RTTI::visit(
+                s, [](Shapes::Circle&) { return 1; }, [](Shapes::Square&) { return 2; });
+        };
+        EXPECT_EQ(describe(circle), 1);
+        EXPECT_EQ(describe(cube), 2);
+        EXPECT_EQ(describe(shape), 0);
+    }
+}  // namespace